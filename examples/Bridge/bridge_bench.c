@@ -0,0 +1,295 @@
+/**
+ * @file bridge_bench.c
+ * @brief Host throughput and latency benchmark for MicroOSBridge.
+ *
+ * Two MicroOS nodes run as two processes joined by a UNIX socket pair, the
+ * host stand-in for a UART. Node 1 exports "bench/data" on channel 1; node 2
+ * imports it and answers samples flagged ECHO on "bench/echo", channel 2.
+ *
+ *   1. Throughput: node 1 streams BENCH_COUNT sequence-numbered samples,
+ *      batched several per frame; node 2 checks that none is lost or
+ *      reordered. Timed until the echo of the last sample returns.
+ *   2. Latency: node 1 sends BENCH_PINGS single samples and waits for each
+ *      echo, flushing at once instead of waiting for the batch interval.
+ *      Prints the round-trip time (two frames, two scheduler passes).
+ *
+ * A thread per process drives MicroOS_TickHandler() at 1 kHz.
+ *
+ * Build (host):
+ *   gcc -O2 -std=gnu11 -pthread -Iinclude examples/Bridge/bridge_bench.c src/MicroOS.c \
+ *       src/MicroOSBridge.c src/MicroOSPool.c src/MicroOSQueue.c -o bridge_bench
+ */
+#define _GNU_SOURCE
+#include "MicroOS.h"
+#include "MicroOSBridge.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_COUNT  200000UL
+#define BENCH_PINGS  2000U
+
+#define FLAG_ECHO    0x1U
+#define FLAG_DONE    0x2U
+
+typedef struct
+{
+    uint32_t seq;
+    uint32_t flags;
+    uint64_t t_ns;
+} Sample_t;
+
+/* samples published per scheduler pass: one frame's worth, so a full frame is
+ * never sealed while the previous one is still being written */
+#define BENCH_BURST  ((MICROOS_BRIDGE_FRAME_MAX - MICROOSBRIDGE_HEADER_SIZE - MICROOSBRIDGE_CRC_SIZE) / \
+                      (MICROOSBRIDGE_RECORD_HEADER + sizeof(Sample_t)))
+
+MICROOS_DEFINE_TOPIC_RING(data_ring, 64, sizeof(Sample_t));
+
+static int link_fd;
+static MicroOSBridge_t bridge;
+
+static size_t link_write(void *ctx, const uint8_t *data, size_t len)
+{
+    ssize_t n = send(*(int *)ctx, data, len, MSG_DONTWAIT);
+    return n > 0 ? (size_t)n : 0U;
+}
+
+static size_t link_read(void *ctx, uint8_t *data, size_t len)
+{
+    ssize_t n = recv(*(int *)ctx, data, len, MSG_DONTWAIT);
+    return n > 0 ? (size_t)n : 0U;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+}
+
+static void *tick_thread(void *arg)
+{
+    struct timespec ms = {0, 1000000L};
+
+    (void)arg;
+
+    for (;;)
+    {
+        nanosleep(&ms, NULL);
+        MicroOS_TickHandler();
+    }
+
+    return NULL;
+}
+
+static void link_task(void *arg)
+{
+    (void)arg;
+    MicroOSBridge_Poll(&bridge);
+}
+
+static void start_node(uint8_t node, int fd, uint32_t flush_ticks)
+{
+    MicroOSBridge_Transport_t transport = {link_write, link_read, &link_fd};
+    pthread_t tick;
+
+    link_fd = fd;
+    MicroOS_Init();
+    MicroOSBridge_Init(&bridge, node, &transport, flush_ticks);
+
+    MicroOS_CreateTopic(0, "bench/data");
+    MicroOS_SetTopicMode(0, MICROOS_TOPIC_LOSSLESS, &data_ring);
+    MicroOS_CreateTopic(1, "bench/echo");
+
+    MicroOS_AddTask(0, "link", link_task, NULL, 0);
+    pthread_create(&tick, NULL, tick_thread, NULL);
+}
+
+/*------------------------------------------------------------------------------
+ * Node 2: checks the stream and echoes flagged samples
+ *----------------------------------------------------------------------------*/
+
+static Sample_t echo_out;
+static uint32_t expect;
+static uint32_t lost;
+
+static void on_data(void *param)
+{
+    const Sample_t *s = (const Sample_t *)param;
+
+    if (s->flags & FLAG_DONE)
+    {
+        printf("node 2: %u samples in %u frames, %u lost, %u duplicate frames, %u bad frames\n",
+               bridge.RxSamples, bridge.RxFrames, lost, bridge.RxDuplicates, bridge.RxErrors);
+        fflush(stdout);
+        _exit(lost != 0U);
+    }
+
+    if (s->seq != expect)
+    {
+        lost += s->seq - expect;
+    }
+    expect = s->seq + 1U;
+
+    if (s->flags & FLAG_ECHO)
+    {
+        echo_out = *s;
+        MicroOS_Publish(1, &echo_out);
+    }
+}
+
+static void run_echo_node(int fd)
+{
+    start_node(2, fd, 0);       /* echoes leave at once */
+    MicroOSBridge_Import(&bridge, 1, 0, NULL, sizeof(Sample_t));
+    MicroOSBridge_Export(&bridge, 1, 2, sizeof(Sample_t), true);
+    MicroOS_Subscribe(0, 0, "check", on_data);
+    MicroOS_StartScheduler();
+}
+
+/*------------------------------------------------------------------------------
+ * Node 1: streams, then pings
+ *----------------------------------------------------------------------------*/
+
+static Sample_t echo_in;
+static volatile uint32_t echoed = UINT32_MAX;
+static volatile uint64_t echo_ns;
+
+static void on_echo(void *param)
+{
+    const Sample_t *s = (const Sample_t *)param;
+
+    echoed = s->seq;
+    echo_ns = now_ns() - s->t_ns;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void bench_task(void *arg)
+{
+    static uint32_t seq;
+    static uint64_t t0;
+    static uint32_t pings;
+    static uint64_t rtt[BENCH_PINGS];
+    static int waiting;
+
+    (void)arg;
+
+    if (seq < BENCH_COUNT)
+    {
+        if (seq == 0U)
+        {
+            t0 = now_ns();
+        }
+
+        // 上一帧还没写完时不再塞样本, 让链路的背压传回发布者
+        for (uint32_t i = 0; i < BENCH_BURST && seq < BENCH_COUNT && bridge.TxLen == 0U; i++)
+        {
+            Sample_t s = {seq, (seq == BENCH_COUNT - 1U) ? FLAG_ECHO : 0U, now_ns()};
+
+            if (MicroOS_Publish(0, &s) != MICROOS_OK)
+            {
+                break;
+            }
+            seq++;
+        }
+        return;
+    }
+
+    if (pings == 0U && !waiting)
+    {
+        if (echoed != BENCH_COUNT - 1U)
+        {
+            return;
+        }
+
+        double sec = (now_ns() - t0) / 1e9;
+        printf("throughput: %lu samples of %u bytes in %.3f s, %.0f samples/s, %u frames, %.1f wire bytes per sample\n",
+               BENCH_COUNT, (unsigned int)sizeof(Sample_t), sec, BENCH_COUNT / sec, bridge.TxFrames,
+               (double)(bridge.TxFrames * (MICROOSBRIDGE_HEADER_SIZE + MICROOSBRIDGE_CRC_SIZE) +
+                        bridge.TxSamples * (MICROOSBRIDGE_RECORD_HEADER + sizeof(Sample_t))) / bridge.TxSamples);
+    }
+
+    if (waiting)
+    {
+        MicroOSBridge_Flush(&bridge);
+        if (echoed != seq)
+        {
+            return;
+        }
+        rtt[pings++] = echo_ns;
+        seq++;
+        waiting = 0;
+    }
+
+    if (pings < BENCH_PINGS)
+    {
+        Sample_t s = {seq, FLAG_ECHO, now_ns()};
+        MicroOS_Publish(0, &s);
+        waiting = 1;
+        return;
+    }
+
+    qsort(rtt, BENCH_PINGS, sizeof(rtt[0]), cmp_u64);
+    printf("latency: %u round trips, min %.1f us, median %.1f us, p99 %.1f us, max %.1f us\n",
+           BENCH_PINGS, rtt[0] / 1e3, rtt[BENCH_PINGS / 2U] / 1e3, rtt[BENCH_PINGS * 99U / 100U] / 1e3, rtt[BENCH_PINGS - 1U] / 1e3);
+    printf("node 1: %u samples sent, %u dropped\n", bridge.TxSamples, bridge.TxDropped);
+    fflush(stdout);
+
+    Sample_t done = {seq, FLAG_DONE, 0};
+    MicroOS_Publish(0, &done);
+    MicroOS_SuspendTask(1);
+}
+
+static void exit_task(void *arg)
+{
+    int status = 1;
+
+    (void)arg;
+
+    // 结束样本进了批并且整帧写出后, 等对端退出
+    if (bridge.TxSamples != BENCH_COUNT + BENCH_PINGS + 1U || MicroOSBridge_Flush(&bridge) != MICROOS_OK || bridge.TxLen != 0U)
+    {
+        return;
+    }
+
+    wait(&status);
+    exit(WIFEXITED(status) ? WEXITSTATUS(status) : 1);
+}
+
+int main(void)
+{
+    int sv[2];
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+    {
+        perror("socketpair");
+        return 1;
+    }
+
+    if (fork() == 0)
+    {
+        close(sv[0]);
+        run_echo_node(sv[1]);
+    }
+
+    close(sv[1]);
+    start_node(1, sv[0], 1);    /* batch for up to one tick */
+    MicroOSBridge_Export(&bridge, 0, 1, sizeof(Sample_t), false);
+    MicroOSBridge_Import(&bridge, 2, 1, &echo_in, sizeof(Sample_t));
+    MicroOS_Subscribe(1, 0, "echo", on_echo);
+    MicroOS_AddTask(1, "bench", bench_task, NULL, 0);
+    MicroOS_AddTask(2, "exit", exit_task, NULL, 0);
+    MicroOS_StartScheduler();
+
+    return 0;
+}
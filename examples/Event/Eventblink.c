@@ -10,7 +10,7 @@ void UserEvent_BlinkLed(void *param) {
 
 // Task that triggers the blink event every 500ms
 void Task_TriggerBlinkEvent(void *param) {
-    MicroOS_TriggerEvent(0,NULL);
+    MicroOS_TriggerEvent(0);
 }
 
 int main(void) {
@@ -19,8 +19,8 @@ int main(void) {
         return -1;
     }
 
-    // Register event ID 0 with the LED blink callback
-    MicroOS_RegisterEvent(0, "BlinkEvent", UserEvent_BlinkLed);
+    // Register event ID 0 with the LED blink callback at priority 0 (highest)
+    MicroOS_RegisterEvent(0, "BlinkEvent", UserEvent_BlinkLed, NULL, 0);
 
     // Add a task that triggers the blink event every 500ms
     MicroOS_AddTask(0, "TriggerTask", Task_TriggerBlinkEvent, NULL, 500);
@@ -1,12 +1,18 @@
 #include "MicroOS.h"
 #include <stdio.h> // 仅用于示例打印
 
+/* ------------------------------------------------------------------ */
+/* 消息事件队列：每个队列按自己的需求定义深度和单条消息大小            */
+/* UART 一帧 4 字节，最多缓存 8 帧                                     */
+/* ------------------------------------------------------------------ */
+MICROOSQUEUE_DEFINE(UartQueue, 8, 4);
+
 /* ------------------------------------------------------------------ */
 /* 消息事件回调：调度器会在主循环里自动把队列中每一条消息依次弹出来调用  */
 /* ------------------------------------------------------------------ */
 void UART_MessageHandler(const MicroOSQueue_Message_t *msg)
 {
-    printf("[UART_MessageHandler] got %u bytes: ", msg->len);
+    printf("[UART_MessageHandler] got %u bytes: ", (unsigned int)msg->len);
     for (uint16_t i = 0; i < msg->len; i++)
     {
         printf("%02X ", msg->data[i]);
@@ -35,7 +41,7 @@ void UART_RX_IRQHandler(void)
     if (ret == MICROOS_QUEUE_FULL)
     {
         // 队列满了：说明消费速度跟不上突发的触发速度，
-        // 需要考虑加大 MICROOS_QUEUE_DEPTH，或者在这里加诊断计数
+        // 需要考虑加大 UartQueue 的深度，或者在这里加诊断计数
         printf("[UART_RX_IRQHandler] queue full, frame dropped\n");
     }
 }
@@ -57,9 +63,9 @@ int main(void)
         return -1;
     }
 
-    // 注册消息事件：ID 0，绑定回调，不用像普通 Event 那样在这里传数据，
+    // 注册消息事件：ID 0，绑定回调和队列，不用像普通 Event 那样在这里传数据，
     // 数据是每次 TriggerMessageEvent 时才传入的
-    MicroOS_RegisterMessageEvent(0, "UART_RX", UART_MessageHandler);
+    MicroOS_RegisterMessageEvent(0, "UART_RX", UART_MessageHandler, &UartQueue);
 
     // 一个普通周期任务，1000ms 打印一次心跳，方便和消息事件的触发做对比
     MicroOS_AddTask(0, "Heartbeat_Task", Heartbeat_Task, NULL, OS_MS_TICKS(1000));
@@ -12,6 +12,7 @@
  *   - The maximum number of tasks is defined by MICROOS_TASK_SIZE (default: 10).
  *   - Static allocation only; no dynamic stack allocation to avoid heap fragmentation in resource-limited MCUs.
  *   - Event system uses a fixed pool defined by OS_EVENT_POOLSIZE.
+ *   - Triggered events are dispatched highest priority first (0 = highest); equal priorities run in pool order.
  *   - Tick-driven scheduler: call MicroOS_TickHandler() from a periodic hardware timer ISR.
  *   - To speed up scheduling accuracy, ensure MICROOS_FREQ_HZ matches the hardware tick frequency.
  *   - OSdelay uses a static delay task pool; modify OS_DELAY_POOLSIZE to adjust pool size.
@@ -23,6 +24,7 @@
 
 #include "MicroOS_types.h"
 #include "MicroOSQueue.h"
+#include "MicroOSPool.h"
 #include "MicroOS_com.h"
 #include "MicroOS_conf.h"
 
@@ -44,9 +46,25 @@ extern MicroOS_Status_t MicroOS_Init(void);
  * @param name          Event name
  * @param EventFunction Callback function to be executed when the event is triggered.
  * @param Userdata User data pointer
+ * @param Priority      Dispatch priority, 0 is the highest (must be less than MICROOS_EVENT_PRIORITY_NUM).
  * @return MicroOS_Status_t Returns MICROOS_OK on success or an error code if the event pool is full.
  */
-extern MicroOS_Status_t MicroOS_RegisterEvent(uint8_t id, char *name, MicroOS_EventFunction_t EventFunction, const void *Userdata);
+extern MicroOS_Status_t MicroOS_RegisterEvent(uint8_t id, char *name, MicroOS_EventFunction_t EventFunction, const void *Userdata, uint8_t Priority);
+
+/**
+ * @brief Registers a new batch event or updates an existing one.
+ *
+ * @note The callback runs once per scheduler pass and receives the number of
+ *       triggers accumulated since its previous call.
+ *
+ * @param id            Unique event identifier.
+ * @param name          Event name
+ * @param BatchFunction Callback function receiving the trigger count.
+ * @param Userdata User data pointer
+ * @param Priority      Dispatch priority, 0 is the highest (must be less than MICROOS_EVENT_PRIORITY_NUM).
+ * @return MicroOS_Status_t Returns MICROOS_OK on success or an error code if the event pool is full.
+ */
+extern MicroOS_Status_t MicroOS_RegisterBatchEvent(uint8_t id, char *name, MicroOS_BatchEventFunction_t BatchFunction, const void *Userdata, uint8_t Priority);
 
 /**
  * @brief Deletes an event from the active event list.
@@ -58,6 +76,10 @@ extern void MicroOS_DeleteEvent(uint8_t id);
 /**
  * @brief Triggers an event, marking it to be executed in the scheduler loop.
  *
+ * @note Triggers are counted atomically and never collapse: a plain event runs
+ *       its callback once per trigger, a batch event receives the count. Safe to
+ *       call from any interrupt priority.
+ *
  * @param id Unique event identifier to trigger.
  * @param Userdata      Pointer to user-defined data passed to the callback function.
  * @return MicroOS_Status_t Returns MICROOS_OK if the event was found and triggered, otherwise MICROOS_ERROR.
@@ -181,6 +203,94 @@ extern MicroOS_Status_t MicroOS_ResetTask(uint8_t id);
  */
 extern MicroOS_Status_t MicroOS_DeleteTask(uint8_t id);
 
+#if MICROOS_EVENTGROUP_ENABLE
+/**
+ * @brief Create an event group.
+ *
+ * @param id Event group id (less than MICROOS_EVENTGROUP_SIZE)
+ * @param name Event group name
+ * @return MicroOS_Status_t
+ */
+extern MicroOS_Status_t MicroOS_CreateEventGroup(uint8_t id, const char *name);
+
+/**
+ * @brief Delete an event group together with the events waiting on it.
+ *
+ * @param id Event group id
+ * @return MicroOS_Status_t
+ */
+extern MicroOS_Status_t MicroOS_DeleteEventGroup(uint8_t id);
+
+/**
+ * @brief Register an event that fires when an event group condition is met.
+ *
+ * @note The event is a normal pool event: it can be suspended, resumed and deleted
+ *       by event_id. The condition is evaluated in the scheduler loop every time bits
+ *       are set on the group.
+ *       MICROOS_EVENTGROUP_AUTO_CLEAR clears only the mask bits that were set when the
+ *       condition was evaluated: with WAIT_ANY the mask bits that were not set stay
+ *       untouched, and a bit an ISR sets during dispatch is kept for the next pass.
+ *
+ * @param group_id Event group id
+ * @param event_id Unique event identifier
+ * @param name Event name
+ * @param mask Event group bits to wait for
+ * @param options MICROOS_EVENTGROUP_WAIT_ANY or MICROOS_EVENTGROUP_WAIT_ALL, optionally | MICROOS_EVENTGROUP_AUTO_CLEAR
+ * @param EventFunction Callback function
+ * @param Userdata User data pointer
+ * @param Priority Dispatch priority, 0 is the highest
+ * @return MicroOS_Status_t
+ */
+extern MicroOS_Status_t MicroOS_WaitEventGroup(uint8_t group_id, uint8_t event_id, char *name, uint32_t mask, uint8_t options, MicroOS_EventFunction_t EventFunction, const void *Userdata, uint8_t Priority);
+
+/**
+ * @brief Set event group bits. Safe to call from an ISR.
+ *
+ * @param id Event group id
+ * @param bits Bits to set
+ * @return MicroOS_Status_t
+ */
+extern MicroOS_Status_t MicroOS_SetEventGroupBits(uint8_t id, uint32_t bits);
+
+/**
+ * @brief Clear event group bits. Safe to call from an ISR.
+ *
+ * @param id Event group id
+ * @param bits Bits to clear
+ * @return MicroOS_Status_t
+ */
+extern MicroOS_Status_t MicroOS_ClearEventGroupBits(uint8_t id, uint32_t bits);
+
+/**
+ * @brief Get the current event group bits.
+ *
+ * @param id Event group id
+ * @return uint32_t Event group bits
+ */
+extern uint32_t MicroOS_GetEventGroupBits(uint8_t id);
+#endif
+
+#if MICROOS_DEFER_ENABLE
+/**
+ * @brief Defer a function call to the scheduler loop.
+ *
+ * @note Lock-free and allocation-free, callable from any interrupt priority.
+ *       At most MICROOS_DEFER_BATCH calls run per scheduler pass, in FIFO order.
+ *
+ * @param DeferFunction Function to call from the scheduler loop
+ * @param arg Argument passed to DeferFunction
+ * @return MicroOS_Status_t MICROOS_OK, or MICROOS_QUEUE_FULL if the ring is full
+ */
+extern MicroOS_Status_t MicroOS_Defer(MicroOS_DeferFunction_t DeferFunction, void *arg);
+
+/**
+ * @brief Get the number of deferred calls rejected because the ring was full.
+ *
+ * @return uint32_t Rejected call count
+ */
+extern uint32_t MicroOS_DeferDropped(void);
+#endif
+
 #if MICROOS_MESSAGEEVENT_ENABLE
 /**
  * @brief Registers a new Message event or updates an existing one.
@@ -188,13 +298,48 @@ extern MicroOS_Status_t MicroOS_DeleteTask(uint8_t id);
  * @param id Message Event id
  * @param name Message Event ASCII name
  * @param function
+ * @param queue Queue holding the pending messages, declared with MICROOSQUEUE_DEFINE().
+ *              The handler receives a pointer into the queue slot, valid for the duration of the call.
+ * @return MicroOS_Status_t
+ */
+extern MicroOS_Status_t MicroOS_RegisterMessageEvent(uint8_t id, const char *name, MicroOSQueue_EventFunction_t function, MicroOSQueue_Obj_t *queue);
+
+/**
+ * @brief Registers a Message event backed by a multi-producer queue.
+ *
+ * @note Use this when MicroOS_TriggerMessageEvent() is called from several
+ *       interrupt priorities or cores at once; producers never mask interrupts.
+ *
+ * @param id Message Event id
+ * @param name Message Event ASCII name
+ * @param function
+ * @param queue Queue declared with MICROOSQUEUE_DEFINE_MPSC()
  * @return MicroOS_Status_t
  */
-extern MicroOS_Status_t MicroOS_RegisterMessageEvent(uint8_t id, const char *name, MicroOSQueue_EventFunction_t function);
+extern MicroOS_Status_t MicroOS_RegisterMessageEventMPSC(uint8_t id, const char *name, MicroOSQueue_EventFunction_t function, MicroOSQueue_MPSC_t *queue);
+
+/**
+ * @brief Registers a Message event backed by a priority queue.
+ *
+ * @note Dispatch always drains the most urgent non-empty level first, so
+ *       messages sent with MicroOS_TriggerMessageEventPrio() at level 0 do
+ *       not wait behind a backlog on lower levels.
+ *
+ * @param id Message Event id
+ * @param name Message Event ASCII name
+ * @param function
+ * @param queue Queue declared with MICROOSQUEUE_DEFINE_PRIO()
+ * @return MicroOS_Status_t
+ */
+extern MicroOS_Status_t MicroOS_RegisterMessageEventPrio(uint8_t id, const char *name, MicroOSQueue_EventFunction_t function, MicroOSQueue_Prio_t *queue);
 
 /**
  * @brief Delete the task with the specified ID
  *
+ * @note Called from the event's own handler, the queue is drained once the
+ *       handler returns, so the message it is reading stays valid. Until then
+ *       the id cannot be registered again on the same queue (MICROOS_BUSY).
+ *
  * @param id Message Event id
  * @return MicroOS_Status_t
  */
@@ -210,6 +355,19 @@ extern MicroOS_Status_t MicroOS_DeleteMessageEvent(uint8_t id);
  */
 extern MicroOS_Status_t MicroOS_TriggerMessageEvent(uint8_t id, const void *data, size_t data_len);
 
+/**
+ * @brief Triggers a Message Event at a priority level (events registered with MicroOS_RegisterMessageEventPrio()).
+ *
+ * @note MicroOS_TriggerMessageEvent() on such an event uses the lowest level.
+ *
+ * @param id Message Event id
+ * @param prio Level, 0 is the most urgent
+ * @param data Queue data
+ * @param data_len data len
+ * @return MicroOS_Status_t MICROOS_INVALID_PARAM when the event has no priority queue or prio is out of range
+ */
+extern MicroOS_Status_t MicroOS_TriggerMessageEventPrio(uint8_t id, uint8_t prio, const void *data, size_t data_len);
+
 /**
  * @brief Suspends an Message event, preventing it from being executed even if triggered.
  *
@@ -225,6 +383,117 @@ extern MicroOS_Status_t MicroOS_SuspendMessageEvent(uint8_t id);
  * @return MicroOS_Status_t
  */
 extern MicroOS_Status_t MicroOS_ResumeMessageEvent(uint8_t id);
+
+/**
+ * @brief Sets how many messages a Message event may drain in one scheduler pass.
+ *
+ * @param id Message Event id
+ * @param budget Messages per pass (>= 1), default MICROOS_MESSAGEEVENT_BUDGET
+ * @return MicroOS_Status_t
+ */
+extern MicroOS_Status_t MicroOS_SetMessageEventBudget(uint8_t id, uint8_t budget);
+
+/**
+ * @brief Delivers a Message event's messages in batches instead of one call per message.
+ *
+ * @note Each call receives up to MICROOS_MESSAGEEVENT_BATCH_MAX messages (bounded by the
+ *       budget) as an array of pointers into the queue; they are released after it returns.
+ *
+ * @param id Message Event id
+ * @param function Batch handler, NULL restores per-message delivery
+ * @return MicroOS_Status_t
+ */
+extern MicroOS_Status_t MicroOS_SetMessageEventBatchHandler(uint8_t id, MicroOSQueue_BatchFunction_t function);
+
+/**
+ * @brief Switches a Message event to pooled payloads: its queue carries block references only.
+ *
+ * @note MicroOS_TriggerMessageEvent() and MicroOS_TriggerMessageEventPrio() then copy the
+ *       payload once into a block from pool and queue a reference, so the queue can be declared with
+ *       MICROOSQUEUE_DEFINE(q, depth, sizeof(MicroOSQueue_Message_t *)) and payload RAM is
+ *       sized for the traffic of all events together. Call it while the queue is empty.
+ *       The queue must keep MICROOSQUEUE_POLICY_REJECT, otherwise a dropped reference would leak its block.
+ *
+ * @param id Message Event id
+ * @param pool Block pool, NULL returns to copying payloads into the queue
+ * @return MicroOS_Status_t MICROOS_BUSY when messages are pending
+ */
+extern MicroOS_Status_t MicroOS_SetMessageEventPool(uint8_t id, MicroOSPool_t *pool);
+
+/**
+ * @brief Queues an already filled pooled block to a Message event without copying it.
+ *
+ * @note The event takes its own reference; the caller keeps (and must release) its own.
+ *       Queue the same block to several events to fan one payload out to several consumers:
+ *       msg = MicroOSPool_Alloc(&pool, len); fill msg->data;
+ *       MicroOS_TriggerMessageEventShared(a, msg); MicroOS_TriggerMessageEventShared(b, msg);
+ *       MicroOSPool_Release(msg);
+ *
+ * @param id Message Event id, switched to pooled payloads with MicroOS_SetMessageEventPool()
+ * @param msg a message returned by MicroOSPool_Alloc()
+ * @return MicroOS_Status_t MICROOS_INVALID_PARAM when the event does not use a pool
+ */
+extern MicroOS_Status_t MicroOS_TriggerMessageEventShared(uint8_t id, const MicroOSQueue_Message_t *msg);
+#endif
+
+#if MICROOS_RPC_ENABLE
+/**
+ * @brief Sends a request to a Message event and registers a completion callback for the reply.
+ *
+ * @note The event's handler receives the request as a normal message; it reads the call ID
+ *       with MicroOS_RpcCallId() and the payload with MicroOS_RpcPayload(), and answers with
+ *       MicroOS_RpcReply() right away or later. The queue's msg_size must cover
+ *       MICROOS_RPC_HEADER_SIZE + data_len. Call from the scheduler loop (tasks, handlers),
+ *       not from interrupts. The callback runs in the scheduler loop exactly once, with the
+ *       reply or with MICROOS_TIMEOUT, unless the call is cancelled.
+ *
+ * @param id Target Message Event id
+ * @param data Request payload, at most MICROOS_RPC_REQUEST_SIZE bytes
+ * @param data_len Request length
+ * @param callback Completion callback
+ * @param arg Argument passed to callback
+ * @param Ticks Timeout in ticks OS_MS_TICKS(ms), 0 waits forever
+ * @param call_id Receives the call ID (optional, for MicroOS_RpcCancel())
+ * @return MicroOS_Status_t MICROOS_BUSY when all MICROOS_RPC_PENDING_SIZE calls are pending
+ */
+extern MicroOS_Status_t MicroOS_RpcCall(uint8_t id, const void *data, size_t data_len, MicroOS_RpcCallback_t callback, void *arg, uint32_t Ticks, uint32_t *call_id);
+
+/**
+ * @brief Answers a request, callable from any context.
+ *
+ * @note The reply is copied into the pending call; the caller's callback runs in the next scheduler pass.
+ *
+ * @param call_id Call ID from MicroOS_RpcCallId()
+ * @param data Reply payload, at most MICROOS_RPC_REPLY_SIZE bytes
+ * @param data_len Reply length
+ * @return MicroOS_Status_t MICROOS_TIMEOUT when the call already timed out, was cancelled or answered
+ */
+extern MicroOS_Status_t MicroOS_RpcReply(uint32_t call_id, const void *data, size_t data_len);
+
+/**
+ * @brief Cancels a pending call; its callback will not run.
+ *
+ * @param call_id Call ID from MicroOS_RpcCall()
+ * @return MicroOS_Status_t MICROOS_ERROR when the call is no longer pending
+ */
+extern MicroOS_Status_t MicroOS_RpcCancel(uint32_t call_id);
+
+/**
+ * @brief Gets the call ID of a request message, for MicroOS_RpcReply().
+ *
+ * @param msg Request message received by the handler
+ * @return uint32_t Call ID
+ */
+extern uint32_t MicroOS_RpcCallId(const MicroOSQueue_Message_t *msg);
+
+/**
+ * @brief Gets the payload of a request message.
+ *
+ * @param msg Request message received by the handler
+ * @param len Receives the payload length
+ * @return const void* Payload
+ */
+extern const void *MicroOS_RpcPayload(const MicroOSQueue_Message_t *msg, size_t *len);
 #endif
 
 #if MICROOS_SUBSCRIPTION_ENABLE
@@ -232,6 +501,8 @@ extern MicroOS_Status_t MicroOS_ResumeMessageEvent(uint8_t id);
  * @brief Register a new publish topic.
  *
  * Create a topic with the specified ID and name. The topic ID must be unique.
+ * With MICROOS_TOPIC_HASH_ENABLE the name must be unique too (it may be NULL
+ * for a topic addressed by ID only) and returns MICROOS_BUSY if it is taken.
  *
  * @param id Topic identifier.
  * @param topic Topic name.
@@ -252,16 +523,34 @@ extern MicroOS_Status_t MicroOS_DeleteTopic(uint8_t id);
 /**
  * @brief Subscribe to a topic.
  *
- * Register a subscriber callback for the specified topic.
+ * Register a subscriber callback for the specified topic. The subscriber is
+ * taken from the pool shared by all topics and delivered to after the
+ * topic's earlier subscribers.
  *
  * @param topic_id Topic identifier.
- * @param sub_id Subscriber identifier.
+ * @param sub_id Subscriber identifier, any value unique within the topic.
  * @param name Subscriber name.
  * @param func Subscriber callback function.
- * @return MicroOS_Status_t Operation result.
+ * @return MicroOS_Status_t Operation result, MICROOS_BUSY if sub_id is taken
+ *         or the pool (MICROOS_SUBSCRIBER_POOL_SIZE) is exhausted.
  */
 extern MicroOS_Status_t MicroOS_Subscribe(uint8_t topic_id,uint8_t sub_id,const char *name,MicroOS_SubscriberFunction_t func);
 
+/**
+ * @brief Subscribe to a topic and return the pool handle of the subscriber.
+ *
+ * Same as MicroOS_Subscribe(); the handle unsubscribes in O(1) through
+ * MicroOS_UnsubscribeHandle().
+ *
+ * @param topic_id Topic identifier.
+ * @param sub_id Subscriber identifier, any value unique within the topic.
+ * @param name Subscriber name.
+ * @param func Subscriber callback function.
+ * @param handle Receives the subscriber handle, may be NULL.
+ * @return MicroOS_Status_t Operation result.
+ */
+extern MicroOS_Status_t MicroOS_SubscribeHandle(uint8_t topic_id, uint8_t sub_id, const char *name, MicroOS_SubscriberFunction_t func, MicroOS_SubscriberHandle_t *handle);
+
 /**
  * @brief Unsubscribe from a topic.
  *
@@ -273,6 +562,49 @@ extern MicroOS_Status_t MicroOS_Subscribe(uint8_t topic_id,uint8_t sub_id,const
  */
 extern MicroOS_Status_t MicroOS_Unsubscribe(uint8_t topic_id, uint8_t sub_id);
 
+/**
+ * @brief Unsubscribe by handle and return the subscriber to the pool.
+ *
+ * @param handle Handle from MicroOS_SubscribeHandle().
+ * @return MicroOS_Status_t Operation result, MICROOS_ERROR if the handle is not subscribed.
+ */
+extern MicroOS_Status_t MicroOS_UnsubscribeHandle(MicroOS_SubscriberHandle_t handle);
+
+#if MICROOS_TOPIC_PATTERN_ENABLE
+/**
+ * @brief Subscribe to every topic whose name matches a wildcard filter.
+ *
+ * Names are '/' separated levels; in the filter '+' matches exactly one level
+ * and a trailing '#' matches any number of remaining levels (including none,
+ * so "sensor/#" also matches "sensor"). Matching is done here and in
+ * MicroOS_CreateTopic() and stored as a bitmap per topic, so publishing never
+ * compares strings. The callback receives the same data as the topic's own
+ * subscribers; MicroOS_CurrentTopic() tells which topic it came from.
+ *
+ * @param sub_id Wildcard subscription identifier (< MICROOS_TOPIC_PATTERN_SIZE).
+ * @param filter Filter, e.g. "sensor/+/accel". Must stay valid while subscribed.
+ * @param name Subscriber name.
+ * @param func Subscriber callback function.
+ * @return MicroOS_Status_t MICROOS_INVALID_PARAM for a malformed filter.
+ */
+extern MicroOS_Status_t MicroOS_SubscribePattern(uint8_t sub_id, const char *filter, const char *name, MicroOS_SubscriberFunction_t func);
+
+/**
+ * @brief Remove a wildcard subscription from every topic it matched.
+ *
+ * @param sub_id Wildcard subscription identifier.
+ * @return MicroOS_Status_t Operation result.
+ */
+extern MicroOS_Status_t MicroOS_UnsubscribePattern(uint8_t sub_id);
+#endif
+
+/**
+ * @brief Get the topic being dispatched, for use inside subscriber callbacks.
+ *
+ * @return uint8_t Topic identifier.
+ */
+extern uint8_t MicroOS_CurrentTopic(void);
+
 /**
  * @brief Publish data to a topic.
  *
@@ -284,6 +616,186 @@ extern MicroOS_Status_t MicroOS_Unsubscribe(uint8_t topic_id, uint8_t sub_id);
  */
 extern MicroOS_Status_t MicroOS_Publish(uint8_t topic_id, const void *Userdata);
 
+#if MICROOS_TOPIC_HASH_ENABLE
+/**
+ * @brief Compute the 32-bit FNV-1a hash of a topic name at runtime.
+ *
+ * @param name Topic name.
+ * @return uint32_t Same value as MICROOS_TOPIC_HASH() for the same name.
+ */
+extern uint32_t MicroOS_TopicHash(const char *name);
+
+/**
+ * @brief Resolve a topic ID from its name.
+ *
+ * Hashes the name and confirms the match with one string compare; meant for
+ * initialisation, use MicroOS_PublishByHash() on the hot path.
+ *
+ * @param name Topic name given to MicroOS_CreateTopic().
+ * @param id Receives the topic identifier.
+ * @return MicroOS_Status_t MICROOS_OK, or MICROOS_ERROR when no topic has this name.
+ */
+extern MicroOS_Status_t MicroOS_FindTopic(const char *name, uint8_t *id);
+
+/**
+ * @brief Publish data to the topic whose name hashes to hash.
+ *
+ * O(1) open addressing lookup without string compares. MicroOS_CreateTopic()
+ * rejects names whose hash is already taken, so a hash names one topic only.
+ * Create topics before publishers start, the table is not updated atomically.
+ *
+ * @param hash MICROOS_TOPIC_HASH("name") or MicroOS_TopicHash(name).
+ * @param Userdata Pointer to user-defined data.
+ * @return MicroOS_Status_t Operation result, MICROOS_ERROR when no topic matches.
+ */
+extern MicroOS_Status_t MicroOS_PublishByHash(uint32_t hash, const void *Userdata);
+
+/** Publish to a topic named by a string literal, the name is hashed at compile time */
+#define MICROOS_PUBLISH_BY_NAME(name, Userdata) MicroOS_PublishByHash(MICROOS_TOPIC_HASH(name), (Userdata))
+#endif
+
+/**
+ * @brief Choose how a topic buffers published data.
+ *
+ * MICROOS_TOPIC_LATEST keeps only the last Userdata pointer, a second publish
+ * before dispatch replaces the first. MICROOS_TOPIC_RING and
+ * MICROOS_TOPIC_LOSSLESS copy item_size bytes of every publish into ring and
+ * deliver each sample to every subscriber in order, passing a pointer to the
+ * ring copy. In ring mode a subscriber that falls a whole ring behind skips
+ * ahead and counts overruns; in lossless mode MicroOS_Publish() returns
+ * MICROOS_QUEUE_FULL instead. Resets the ring and all subscriber cursors; call
+ * it before publishing starts. Each queued topic needs its own ring and a
+ * single publisher. Retained mode is set with MicroOS_SetTopicRetained().
+ *
+ * @param topic_id Topic identifier.
+ * @param mode MICROOS_TOPIC_LATEST, MICROOS_TOPIC_RING or MICROOS_TOPIC_LOSSLESS.
+ * @param ring Ring defined with MICROOS_DEFINE_TOPIC_RING(), NULL for latest mode.
+ * @return MicroOS_Status_t Operation result.
+ */
+extern MicroOS_Status_t MicroOS_SetTopicMode(uint8_t topic_id, uint8_t mode, MicroOS_TopicRing_t *ring);
+
+/**
+ * @brief Make a topic keep its latest value inside MicroOS.
+ *
+ * Every MicroOS_Publish() copies value->size bytes into value under a sequence
+ * lock, so the publisher (one task or ISR) never blocks and readers never see
+ * a half-written value. Subscribers are called with a pointer to a consistent
+ * snapshot that stays valid for the duration of the callback; tasks may also
+ * pull the value with MicroOS_ReadTopic() without subscribing.
+ *
+ * @param topic_id Topic identifier.
+ * @param value Value defined with MICROOS_DEFINE_TOPIC_VALUE().
+ * @return MicroOS_Status_t Operation result.
+ */
+extern MicroOS_Status_t MicroOS_SetTopicRetained(uint8_t topic_id, MicroOS_TopicValue_t *value);
+
+/**
+ * @brief Copy the latest value of a retained topic.
+ *
+ * Retries while the publisher is writing and returns MICROOS_BUSY after
+ * MICROOS_TOPIC_READ_RETRIES attempts, which only happens when the caller
+ * preempts the publisher (e.g. a higher priority ISR reading).
+ *
+ * @param topic_id Topic identifier.
+ * @param data Receives the value.
+ * @param size Size of data, at least the value size.
+ * @param seq Receives the number of values published so far, may be NULL.
+ * @return MicroOS_Status_t MICROOS_OK, or MICROOS_QUEUE_EMPTY before the first publish.
+ */
+extern MicroOS_Status_t MicroOS_ReadTopic(uint8_t topic_id, void *data, size_t size, uint32_t *seq);
+
+#if MICROOS_TOPIC_FILTER_ENABLE
+/**
+ * @brief Drop publishes that do not change the topic's value.
+ *
+ * MicroOS_Publish() hashes the first size bytes of the data (FNV-1a) and
+ * returns MICROOS_OK without storing or waking any subscriber when the hash
+ * equals that of the last value let through. A 32-bit hash can in theory miss
+ * a change (1 in 2^32). Meant for a single publisher per topic.
+ *
+ * @param topic_id Topic identifier.
+ * @param size Bytes compared, at most the sample size in ring and retained mode; 0 disables.
+ * @return MicroOS_Status_t Operation result.
+ */
+extern MicroOS_Status_t MicroOS_SetTopicOnChange(uint8_t topic_id, size_t size);
+
+/**
+ * @brief Attach a predicate to a subscriber, checked before its callback.
+ *
+ * The filter reads one 32-bit field at filter->Offset of the published data
+ * and skips the callback unless it passes: above or below a threshold, moved
+ * by at least a band since the last delivered sample, or matching a bit mask.
+ * Set the topic mode first; changing the mode drops filters whose field no
+ * longer fits the sample.
+ *
+ * @param topic_id Topic identifier.
+ * @param sub_id Subscriber identifier.
+ * @param filter Predicate, copied; NULL removes it.
+ * @return MicroOS_Status_t Operation result.
+ */
+extern MicroOS_Status_t MicroOS_SetSubscriberFilter(uint8_t topic_id, uint8_t sub_id, const MicroOS_SubscriberFilter_t *filter);
+#endif
+
+#if MICROOS_TOPIC_RATE_ENABLE
+/**
+ * @brief Limit how often a subscriber is called back.
+ *
+ * The dispatcher skips the callback in O(1) until decimation samples have
+ * arrived and min_interval ticks have passed since the last callback; the
+ * first sample is always delivered. With deliver_latest the newest skipped
+ * sample is delivered as soon as the interval elapses, even if nothing new is
+ * published, so a 10 Hz display of a 1 kHz topic never shows stale data.
+ *
+ * @param topic_id Topic identifier.
+ * @param sub_id Subscriber identifier.
+ * @param min_interval Minimum ticks between callbacks, 0 for no limit.
+ * @param decimation Call back on one of every decimation samples, 0 or 1 for all.
+ * @param deliver_latest Deliver the newest skipped sample when the interval elapses.
+ * @return MicroOS_Status_t Operation result.
+ */
+extern MicroOS_Status_t MicroOS_SetSubscriberRate(uint8_t topic_id, uint8_t sub_id, uint32_t min_interval, uint16_t decimation, bool deliver_latest);
+#endif
+
+#if MICROOS_TOPIC_PRIORITY_ENABLE
+/**
+ * @brief Set the priority of a subscriber within its topic.
+ *
+ * Subscribers of a topic are called highest priority first; equal
+ * priorities are called in subscription order. New subscribers get
+ * MICROOS_SUBSCRIBER_PRIORITY_DEFAULT.
+ *
+ * @param topic_id Topic identifier.
+ * @param sub_id Subscriber identifier.
+ * @param priority Priority, 0 is the highest.
+ * @return MicroOS_Status_t Operation result.
+ */
+extern MicroOS_Status_t MicroOS_SetSubscriberPriority(uint8_t topic_id, uint8_t sub_id, uint8_t priority);
+#endif
+
+/**
+ * @brief Limit the subscriber callbacks a topic may run in one scheduler pass.
+ *
+ * When the budget runs out the remaining subscribers receive the same sample
+ * on the next pass, so a topic with many subscribers cannot hold up tasks.
+ * Wildcard subscribers are called once all topic subscribers have been served.
+ *
+ * @param topic_id Topic identifier.
+ * @param budget Callbacks per pass, 0 for no limit, default MICROOS_TOPIC_BUDGET.
+ * @return MicroOS_Status_t Operation result.
+ */
+extern MicroOS_Status_t MicroOS_SetTopicBudget(uint8_t topic_id, uint8_t budget);
+
+#if MICROOS_TOPIC_RING_ENABLE
+/**
+ * @brief Get the number of samples a subscriber lost to ring overruns.
+ *
+ * @param topic_id Topic identifier.
+ * @param sub_id Subscriber identifier.
+ * @return uint32_t Samples skipped since subscribing or the last mode change.
+ */
+extern uint32_t MicroOS_GetSubscriberOverruns(uint8_t topic_id, uint8_t sub_id);
+#endif
+
 /**
  * @brief Suspend a subscriber.
  *
@@ -0,0 +1,78 @@
+#ifndef MicroOSBridge_H
+#define MicroOSBridge_H
+
+#include "MicroOSBridge_types.h"
+#include "MicroOS_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#if MICROOS_BRIDGE_ENABLE
+/**
+ * @brief Init a bridge on a byte-stream transport
+ *
+ * @note Call MicroOSBridge_Poll() periodically from a task; the bridge is not
+ *       safe to use from an ISR.
+ *
+ * @param bridge a bridge object
+ * @param node Own node id, unique on the link, at most MICROOSBRIDGE_NODE_MAX
+ * @param transport Non-blocking write/read pair, copied into the bridge
+ * @param flush_ticks Ticks a sample may wait for more samples to share its frame, 0 to send at once
+ * @return MicroOS_Status_t
+ */
+MicroOS_Status_t MicroOSBridge_Init(MicroOSBridge_t *bridge, uint8_t node, const MicroOSBridge_Transport_t *transport, uint32_t flush_ticks);
+
+/**
+ * @brief Send every sample published to a topic on a channel
+ *
+ * @note The bridge subscribes to the topic as MICROOS_BRIDGE_SUB_ID. A topic
+ *       is exported by at most one bridge, and never by the bridge importing it.
+ *
+ * @param bridge a bridge object
+ * @param topic_id Local topic
+ * @param channel Id on the wire, matched by the importing nodes
+ * @param size Sample bytes, at most MICROOSBRIDGE_SAMPLE_MAX
+ * @param latest A newer sample replaces one still waiting in the batch instead of queueing behind it
+ * @return MicroOS_Status_t MICROOS_BUSY when the topic is already bridged or the export table is full
+ */
+MicroOS_Status_t MicroOSBridge_Export(MicroOSBridge_t *bridge, uint8_t topic_id, uint8_t channel, size_t size, bool latest);
+
+/**
+ * @brief Publish the samples received on a channel to a local topic
+ *
+ * @param bridge a bridge object
+ * @param channel Id on the wire
+ * @param topic_id Local topic
+ * @param buffer size bytes the sample is copied to before publishing, needed by
+ *        latest-mode topics (they keep the pointer); NULL for ring, lossless and retained topics
+ * @param size Sample bytes, records of another size are dropped
+ * @return MicroOS_Status_t MICROOS_BUSY when the channel is already imported or the import table is full
+ */
+MicroOS_Status_t MicroOSBridge_Import(MicroOSBridge_t *bridge, uint8_t channel, uint8_t topic_id, void *buffer, size_t size);
+
+/**
+ * @brief Send the batched samples now instead of waiting for the flush interval
+ *
+ * @param bridge a bridge object
+ * @return MicroOS_Status_t MICROOS_BUSY while the previous frame is still being written
+ */
+MicroOS_Status_t MicroOSBridge_Flush(MicroOSBridge_t *bridge);
+
+/**
+ * @brief Write pending frames and publish received ones
+ *
+ * @note Receives at most MICROOS_BRIDGE_RX_BUDGET frames per call.
+ *
+ * @param bridge a bridge object
+ * @return MicroOS_Status_t
+ */
+MicroOS_Status_t MicroOSBridge_Poll(MicroOSBridge_t *bridge);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ * @file MicroOSBridge_types.h
+ * @author https://xfp23.github.io
+ * @brief topic bridge types
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MicroOSBridge_TYPES_H
+#define MicroOSBridge_TYPES_H
+
+#include "MicroOS_types.h"
+#include "stdbool.h"
+#include "stddef.h"
+#include "stdint.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Carries topics between MicroOS nodes over a byte-stream link.
+ *
+ * @note Exported topics are subscribed to; their samples are packed into
+ *       frames as records and written to the transport. Frames read from the
+ *       transport are checked and their records published to the local topics
+ *       imported on the same channel. Several samples share a frame until it
+ *       is full or the flush interval elapses.
+ *
+ *       Frame, little-endian:
+ *         0xA5 | len | node | seq | len bytes of records | CRC-16/CCITT-FALSE
+ *       The CRC covers len .. the last record byte. A record is
+ *         channel | size | size bytes of sample
+ *
+ *       A receiver drops its own frames (looped back by a shared bus) and
+ *       frames whose sequence number it has already seen from that node, so
+ *       retransmissions and duplicated paths deliver each sample once.
+ *
+ *       The top bit of node marks the first 32 frames after MicroOSBridge_Init().
+ *       A marked frame from a node whose last frame was unmarked, or a marked
+ *       frame 0 from a node already past frame 0, is a restart: the receiver
+ *       forgets that node's window instead of dropping the restarted sequence
+ *       numbers as duplicates. Limits: a node that restarts within its first 32
+ *       frames and whose new frame 0 is lost can lose up to 32 frames, and a
+ *       late copy of a marked frame can be taken as a restart and delivered again.
+ */
+
+#define MICROOSBRIDGE_SOF           0xA5U
+#define MICROOSBRIDGE_HEADER_SIZE   4U      // sof, len, node, seq
+#define MICROOSBRIDGE_CRC_SIZE      2U
+#define MICROOSBRIDGE_RECORD_HEADER 2U      // channel, size
+#define MICROOSBRIDGE_NODE_START    0x80U   // node flag: frame sent within the first window after Init
+#define MICROOSBRIDGE_NODE_MAX      0x7FU
+#define MICROOSBRIDGE_WINDOW        32U     // frames remembered per peer
+
+/** Bytes of the largest frame on the wire */
+#define MICROOSBRIDGE_FRAME_SIZE (MICROOSBRIDGE_HEADER_SIZE + MICROOS_BRIDGE_FRAME_MAX + MICROOSBRIDGE_CRC_SIZE)
+
+/** Largest sample that fits in a frame */
+#define MICROOSBRIDGE_SAMPLE_MAX (MICROOS_BRIDGE_FRAME_MAX - MICROOSBRIDGE_RECORD_HEADER)
+
+/**
+ * @brief Byte-stream link, UART, CAN-TP, a pipe ...
+ *
+ * @note Neither call may block. write returns the bytes it accepted (the
+ *       bridge retries the rest on the next poll), read the bytes it copied
+ *       into data, 0 when nothing is available.
+ */
+typedef struct
+{
+    size_t (*write)(void *ctx, const uint8_t *data, size_t len);
+    size_t (*read)(void *ctx, uint8_t *data, size_t len);
+    void *ctx;
+} MicroOSBridge_Transport_t;
+
+typedef struct
+{
+    bool IsUsed;
+    bool Latest;                // a newer sample replaces one still waiting in the batch
+    uint8_t Topic;              // local topic id
+    uint8_t Channel;            // id on the wire
+    uint8_t Size;               // sample bytes
+} MicroOSBridge_Export_t;
+
+typedef struct
+{
+    bool IsUsed;
+    uint8_t Channel;            // id on the wire
+    uint8_t Topic;              // local topic id
+    uint8_t Size;               // sample bytes
+    void *Buffer;               // copy of the last sample for latest-mode topics, NULL when the topic copies
+} MicroOSBridge_Import_t;
+
+typedef struct
+{
+    bool IsUsed;
+    uint8_t Node;
+    bool Starting;              // last accepted frame carried MICROOSBRIDGE_NODE_START
+    uint8_t Seq;                // newest sequence number seen
+    uint32_t Window;            // Seq - i seen -> bit i
+} MicroOSBridge_Peer_t;
+
+typedef struct
+{
+    MicroOSBridge_Transport_t Transport;
+    uint8_t Node;               // own node id, written into every frame
+    uint8_t Seq;                // sequence number of the next frame
+    bool Starting;              // still marking frames with MICROOSBRIDGE_NODE_START
+    uint32_t FlushTicks;        // ticks a sample may wait for more to share its frame
+
+    MicroOSBridge_Export_t exports[MICROOS_BRIDGE_EXPORT_NUM];
+    MicroOSBridge_Import_t imports[MICROOS_BRIDGE_IMPORT_NUM];
+    MicroOSBridge_Peer_t peers[MICROOS_BRIDGE_PEER_NUM];
+
+    // 正在攒的一帧记录, 以及已经编码好、还没全部写出的一帧
+    uint8_t Batch[MICROOS_BRIDGE_FRAME_MAX];
+    uint8_t BatchLen;
+    uint32_t BatchTick;         // tick of the first sample in Batch
+    uint8_t TxFrame[MICROOSBRIDGE_FRAME_SIZE];
+    uint16_t TxLen;
+    uint16_t TxSent;
+
+    uint8_t RxFrame[MICROOSBRIDGE_FRAME_SIZE];
+    uint16_t RxLen;
+
+    uint32_t TxFrames;
+    uint32_t TxSamples;
+    uint32_t TxCoalesced;       // samples replaced by a newer one before sending
+    uint32_t TxDropped;         // samples lost because the link could not keep up
+    uint32_t RxFrames;
+    uint32_t RxSamples;
+    uint32_t RxDuplicates;      // frames dropped as already seen or looped back
+    uint32_t RxErrors;          // frames with a bad CRC or length
+    uint32_t RxDropped;         // records with no import, a size mismatch or a failed publish
+} MicroOSBridge_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef MicroOSPool_H
+#define MicroOSPool_H
+
+#include "MicroOSPool_types.h"
+#include "MicroOS_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Init a size class with user-provided storage
+ * 
+ * @note Classes declared with MICROOSPOOL_DEFINE_CLASS() are ready to use without this call.
+ *
+ * @param cls a class object
+ * @param buffer size_t aligned storage of count * MICROOSPOOL_BLOCK_STRIDE(block_size) bytes
+ * @param map Bitmap of MICROOSPOOL_MAP_WORDS(count) words, cleared by this call
+ * @param block_size Maximum payload of a block
+ * @param count Number of blocks
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSPool_InitClass(MicroOSPool_Class_t *cls, void *buffer, uint32_t *map, uint32_t block_size, uint32_t count);
+
+/**
+ * @brief Init a pool over count size classes
+ * 
+ * @note Pools declared with MICROOSPOOL_DEFINE() are ready to use without this call.
+ *
+ * @param pool a pool object
+ * @param classes Size classes, ascending block size; the array must outlive pool
+ * @param count Number of classes
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSPool_Init(MicroOSPool_t *pool, MicroOSPool_Class_t *const *classes, uint8_t count);
+
+/**
+ * @brief Allocate a block for size bytes of payload, safe from any context
+ * 
+ * @note Takes the smallest class that fits and falls back to larger classes when it is exhausted.
+ *       The block starts with one reference and msg->len set to size.
+ *
+ * @param pool a pool object
+ * @param size Payload length
+ * @return MicroOSQueue_Message_t* The block's message, NULL when no class can hold size bytes
+ */
+MicroOSQueue_Message_t *MicroOSPool_Alloc(MicroOSPool_t *pool, size_t size);
+
+/**
+ * @brief Add a reference to a block, e.g. before queueing it to another message event
+ * 
+ * @param msg a message returned by MicroOSPool_Alloc()
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSPool_Retain(const MicroOSQueue_Message_t *msg);
+
+/**
+ * @brief Drop a reference, the block returns to its class when the last one is dropped
+ * 
+ * @param msg a message returned by MicroOSPool_Alloc()
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSPool_Release(const MicroOSQueue_Message_t *msg);
+
+/**
+ * @brief Number of references currently held on a block
+ * 
+ * @param msg a message returned by MicroOSPool_Alloc()
+ * @return uint32_t 
+ */
+uint32_t MicroOSPool_RefCount(const MicroOSQueue_Message_t *msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
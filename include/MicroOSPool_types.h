@@ -0,0 +1,115 @@
+/**
+ * @file MicroOSPool_types.h
+ * @author https://xfp23.github.io
+ * @brief message block pool types
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MicroOSPool_TYPES_H
+#define MicroOSPool_TYPES_H
+
+#include "MicroOS_conf.h"
+#include "MicroOSQueue_types.h"
+#include "stdint.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Fixed-block pool for message payloads, shared by every message event.
+ *
+ * @note A pool is a list of size classes, smallest first. Each class is an
+ *       array of equal blocks plus a bitmap of blocks in use; allocation claims
+ *       a clear bit with a CAS and freeing clears it again, so blocks may be
+ *       allocated and released from any ISR or core without masking interrupts.
+ *       Every block carries a reference count: one payload can be queued to
+ *       several message events and returns to the pool when the last one
+ *       releases it. The handle of a block is the MicroOSQueue_Message_t it
+ *       holds, so handlers read a pooled message exactly like a queued one.
+ */
+
+typedef struct MicroOSPool_Class MicroOSPool_Class_t;
+
+/**
+ * @brief Header in front of every block's message
+ */
+typedef struct
+{
+    MicroOSPool_Class_t *owner; // class the block belongs to
+    volatile uint32_t refs;     // references held, the block is free at 0
+} MicroOSPool_Header_t;
+
+/** Header size rounded up so the message that follows stays size_t aligned */
+#define MICROOSPOOL_HEADER_SIZE \
+    ((sizeof(MicroOSPool_Header_t) + sizeof(size_t) - 1U) / sizeof(size_t) * sizeof(size_t))
+
+/** Bytes taken by one block of a class with block_size bytes of payload */
+#define MICROOSPOOL_BLOCK_STRIDE(block_size) (MICROOSPOOL_HEADER_SIZE + MICROOSQUEUE_SLOT_SIZE(block_size))
+
+/** Number of 32-bit bitmap words for count blocks */
+#define MICROOSPOOL_MAP_WORDS(count) (((count) + 31U) / 32U)
+
+struct MicroOSPool_Class
+{
+    uint8_t *buffer;            // count blocks of stride bytes
+    volatile uint32_t *map;     // MICROOS_BIT(i % 32) of word i / 32 set while block i is in use
+    uint32_t block_size;        // maximum payload of a block
+    uint32_t stride;            // MICROOSPOOL_BLOCK_STRIDE(block_size)
+    uint32_t count;             // number of blocks
+
+    volatile uint32_t Used;     // blocks currently allocated
+    volatile uint32_t Peak;     // most blocks allocated at once
+    volatile uint32_t Failed;   // allocations that found the class exhausted
+};
+
+/** Static initializer for a class on user-provided, size_t aligned storage and a zeroed bitmap */
+#define MICROOSPOOL_CLASS_INITIALIZER(storage, map, block_size, count) \
+    {(uint8_t *)(storage), (map), (block_size), MICROOSPOOL_BLOCK_STRIDE(block_size), (count), 0U, 0U, 0U}
+
+/**
+ * @brief Define a size class together with its storage.
+ *
+ * @param name Class object name
+ * @param block_size Maximum payload of a block (bytes)
+ * @param count Number of blocks
+ */
+#define MICROOSPOOL_DEFINE_CLASS(name, block_size, count)                                          \
+    static size_t name##_storage[(count) * MICROOSPOOL_BLOCK_STRIDE(block_size) / sizeof(size_t)]; \
+    static uint32_t name##_map[MICROOSPOOL_MAP_WORDS(count)];                                      \
+    static MicroOSPool_Class_t name = MICROOSPOOL_CLASS_INITIALIZER(name##_storage, name##_map, block_size, count)
+
+typedef struct
+{
+    MicroOSPool_Class_t *const *classes;  // size classes, ascending block_size
+    uint8_t count;                        // number of classes
+
+} MicroOSPool_t;
+
+/** Static initializer for a pool over an array of count classes */
+#define MICROOSPOOL_INITIALIZER(classes, count) {(classes), (count)}
+
+/**
+ * @brief Define a pool over existing size classes, smallest first.
+ *
+ * @note e.g. many small frames and a few large ones:
+ *       MICROOSPOOL_DEFINE_CLASS(small_blk, 16, 32);
+ *       MICROOSPOOL_DEFINE_CLASS(large_blk, 256, 4);
+ *       MICROOSPOOL_DEFINE(msg_pool, &small_blk, &large_blk);
+ *
+ * @param name Pool object name
+ * @param ... Addresses of the classes, ascending block size
+ */
+#define MICROOSPOOL_DEFINE(name, ...)                                   \
+    static MicroOSPool_Class_t *const name##_classes[] = {__VA_ARGS__}; \
+    static MicroOSPool_t name = MICROOSPOOL_INITIALIZER(name##_classes, (uint8_t)MICROOSQUEUE_COUNT_OF(name##_classes))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
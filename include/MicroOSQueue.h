@@ -10,12 +10,20 @@ extern "C"
 #endif
 
 /**
- * @brief Init MicroOSQueue
+ * @brief Init MicroOSQueue with user-provided storage
  * 
- * @param obj 
+ * @note Queues declared with MICROOSQUEUE_DEFINE() are ready to use without this call.
+ *
+ * @param obj a queue object
+ * @note A power-of-two size enables the mask fast path. MICROOSQUEUE_STORAGE_SIZE(depth, msg_size)
+ *       gives the size that guarantees depth maximum-size messages.
+ *
+ * @param buffer size_t aligned storage
+ * @param size Storage size in bytes, at least MICROOSQUEUE_STORAGE_SIZE(1, msg_size)
+ * @param msg_size Maximum payload of a single message
  * @return MicroOS_Status_t 
  */
-MicroOS_Status_t MicroOSQueue_Init(MicroOSQueue_Obj_t *obj);
+MicroOS_Status_t MicroOSQueue_Init(MicroOSQueue_Obj_t *obj, void *buffer, uint32_t size, uint32_t msg_size);
 
 /**
  * @brief Push queue
@@ -37,6 +45,124 @@ MicroOS_Status_t MicroOSQueue_Push(MicroOSQueue_Obj_t *obj,const void *data,size
  */
 MicroOS_Status_t MicroOSQueue_Pop(MicroOSQueue_Obj_t *obj,void *data,size_t *size);
 
+/**
+ * @brief Reserve the next slot for in-place writing (zero-copy push)
+ * 
+ * @note The payload only becomes visible to the consumer after MicroOSQueue_Commit().
+ *       Only one reservation may be outstanding per queue.
+ *
+ * @param obj a queue object
+ * @param size Maximum number of bytes that will be written
+ * @param data Receives a pointer to the payload area of the slot
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_Reserve(MicroOSQueue_Obj_t *obj,size_t size,void **data);
+
+/**
+ * @brief Publish the slot obtained with MicroOSQueue_Reserve()
+ * 
+ * @param obj a queue object
+ * @param size Number of bytes actually written, at most the size passed to MicroOSQueue_Reserve()
+ * @return MicroOS_Status_t MICROOS_INVALID_PARAM without an open reservation or when size exceeds it
+ */
+MicroOS_Status_t MicroOSQueue_Commit(MicroOSQueue_Obj_t *obj,size_t size);
+
+/**
+ * @brief Read the oldest message in place (zero-copy pop)
+ * 
+ * @note The message stays valid until MicroOSQueue_Release().
+ *
+ * @param obj a queue object
+ * @param msg Receives a pointer to the message inside the queue
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_Peek(MicroOSQueue_Obj_t *obj,const MicroOSQueue_Message_t **msg);
+
+/**
+ * @brief Drop the message obtained with MicroOSQueue_Peek()
+ * 
+ * @param obj a queue object
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_Release(MicroOSQueue_Obj_t *obj);
+
+/**
+ * @brief Push up to count messages of size bytes each, publishing them with a single tail update
+ * 
+ * @param obj a queue object
+ * @param data count * size bytes, message i starts at data + i * size
+ * @param size Length of every message
+ * @param count Number of messages
+ * @return uint32_t Number of messages pushed (stops at the first one that does not fit)
+ */
+uint32_t MicroOSQueue_PushN(MicroOSQueue_Obj_t *obj,const void *data,size_t size,uint32_t count);
+
+/**
+ * @brief Pop up to count messages, returning their space with a single head update
+ * 
+ * @param obj a queue object
+ * @param data Copy buffer, message i is copied to data + i * stride
+ * @param stride Size of one entry in data; a longer message stops the batch and stays queued
+ * @param lens Optional array receiving the length of each message (may be NULL)
+ * @param count Capacity of data / lens in messages
+ * @return uint32_t Number of messages popped
+ */
+uint32_t MicroOSQueue_PopN(MicroOSQueue_Obj_t *obj,void *data,size_t stride,size_t *lens,uint32_t count);
+
+/**
+ * @brief Read up to count of the oldest messages in place, without releasing them
+ * 
+ * @param obj a queue object
+ * @param msgs Receives pointers to the messages inside the queue
+ * @param count Capacity of msgs
+ * @return uint32_t Number of messages returned
+ */
+uint32_t MicroOSQueue_PeekN(MicroOSQueue_Obj_t *obj,const MicroOSQueue_Message_t **msgs,uint32_t count);
+
+/**
+ * @brief Drop up to count of the oldest messages with a single head update
+ * 
+ * @param obj a queue object
+ * @param count Number of messages
+ * @return uint32_t Number of messages dropped
+ */
+uint32_t MicroOSQueue_ReleaseN(MicroOSQueue_Obj_t *obj,uint32_t count);
+
+/**
+ * @brief Set what happens when a message does not fit
+ * 
+ * @note MICROOSQUEUE_POLICY_REJECT (default) returns MICROOS_QUEUE_FULL, MICROOSQUEUE_POLICY_DROP_NEWEST
+ *       discards the new message and returns MICROOS_OK, MICROOSQUEUE_POLICY_OVERWRITE_OLDEST discards
+ *       the oldest messages to make room (never one the consumer is holding between Peek and Release,
+ *       MICROOS_QUEUE_FULL is still returned when only held messages are left).
+ *       Change the policy only while the queue is idle.
+ *       MICROOSQUEUE_POLICY_OVERWRITE_OLDEST needs a buffer of at most MICROOSQUEUE_OVERWRITE_SIZE_MAX bytes.
+ *
+ * @param obj a queue object
+ * @param policy MICROOSQUEUE_POLICY_xxx
+ * @return MicroOS_Status_t MICROOS_INVALID_PARAM for an unknown policy or overwrite on a larger buffer
+ */
+MicroOS_Status_t MicroOSQueue_SetPolicy(MicroOSQueue_Obj_t *obj, uint8_t policy);
+
+#if MICROOS_QUEUE_STATS_ENABLE
+/**
+ * @brief Read the queue counters (pushes, pops, drops, overwrites, high-water mark)
+ * 
+ * @param obj a queue object
+ * @param stats Receives a snapshot of the counters
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_GetStats(MicroOSQueue_Obj_t *obj, MicroOSQueue_Stats_t *stats);
+#endif
+
+/**
+ * @brief Clear the queue counters
+ * 
+ * @param obj a queue object
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_ResetStats(MicroOSQueue_Obj_t *obj);
+
 /**
  * @brief the queue object is empty
  * 
@@ -49,6 +175,8 @@ bool MicroOSQueue_IsEmpty(MicroOSQueue_Obj_t *obj);
 /**
  * @brief the queue object is full
  * 
+ * @note Full means a maximum-size message would not fit; shorter messages may still be accepted.
+ *
  * @param obj a queue object
  * @return true is full
  * @return false not full
@@ -58,12 +186,271 @@ bool MicroOSQueue_IsFull(MicroOSQueue_Obj_t *obj);
 /**
  * @brief Reset the queue
  * 
+ * @note Not lock-free: neither the producer nor the consumer may be active.
+ *
  * @param obj a queue object
  * @return MicroOS_Status_t 
  */
 MicroOS_Status_t MicroOSQueue_Reset(MicroOSQueue_Obj_t *obj);
 
 
+/**
+ * @brief Init an MPSC queue with user-provided storage
+ * 
+ * @note Queues declared with MICROOSQUEUE_DEFINE_MPSC() are ready to use without this call.
+ *
+ * @param obj an MPSC queue object
+ * @param buffer size_t aligned storage of at least MICROOSQUEUE_MPSC_STORAGE_SIZE(depth, msg_size) bytes
+ * @param depth Number of messages, a power of two (>= 2)
+ * @param msg_size Maximum payload of a single message
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_MPSC_Init(MicroOSQueue_MPSC_t *obj, void *buffer, uint32_t depth, uint32_t msg_size);
+
+/**
+ * @brief Push to an MPSC queue, safe from any number of concurrent producers
+ * 
+ * @param obj an MPSC queue object
+ * @param data User push data
+ * @param size data len
+ * @return MicroOS_Status_t MICROOS_QUEUE_FULL when no slot is free
+ */
+MicroOS_Status_t MicroOSQueue_MPSC_Push(MicroOSQueue_MPSC_t *obj,const void *data,size_t size);
+
+/**
+ * @brief Read the oldest message of an MPSC queue in place (consumer only)
+ * 
+ * @param obj an MPSC queue object
+ * @param msg Receives a pointer to the message inside the queue
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_MPSC_Peek(MicroOSQueue_MPSC_t *obj,const MicroOSQueue_Message_t **msg);
+
+/**
+ * @brief Drop the message obtained with MicroOSQueue_MPSC_Peek() (consumer only)
+ * 
+ * @param obj an MPSC queue object
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_MPSC_Release(MicroOSQueue_MPSC_t *obj);
+
+/**
+ * @brief Read up to count published messages of an MPSC queue in place (consumer only)
+ * 
+ * @param obj an MPSC queue object
+ * @param msgs Receives pointers to the messages inside the queue
+ * @param count Capacity of msgs
+ * @return uint32_t Number of messages returned, stops at the first slot not yet published
+ */
+uint32_t MicroOSQueue_MPSC_PeekN(MicroOSQueue_MPSC_t *obj,const MicroOSQueue_Message_t **msgs,uint32_t count);
+
+/**
+ * @brief Drop up to count messages of an MPSC queue (consumer only)
+ * 
+ * @param obj an MPSC queue object
+ * @param count Number of messages
+ * @return uint32_t Number of messages dropped
+ */
+uint32_t MicroOSQueue_MPSC_ReleaseN(MicroOSQueue_MPSC_t *obj,uint32_t count);
+
+/**
+ * @brief the MPSC queue has no published message at its head
+ * 
+ * @param obj an MPSC queue object
+ * @return true is empty
+ * @return false not empty
+ */
+bool MicroOSQueue_MPSC_IsEmpty(MicroOSQueue_MPSC_t *obj);
+
+/**
+ * @brief Set what happens when an MPSC queue is full
+ * 
+ * @param obj an MPSC queue object
+ * @param policy MICROOSQUEUE_POLICY_REJECT or MICROOSQUEUE_POLICY_DROP_NEWEST (overwrite is not supported)
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_MPSC_SetPolicy(MicroOSQueue_MPSC_t *obj, uint8_t policy);
+
+#if MICROOS_QUEUE_STATS_ENABLE
+/**
+ * @brief Read the MPSC queue counters
+ * 
+ * @param obj an MPSC queue object
+ * @param stats Receives a snapshot of the counters
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_MPSC_GetStats(MicroOSQueue_MPSC_t *obj, MicroOSQueue_Stats_t *stats);
+#endif
+
+/**
+ * @brief Clear the MPSC queue counters
+ * 
+ * @param obj an MPSC queue object
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_MPSC_ResetStats(MicroOSQueue_MPSC_t *obj);
+
+/**
+ * @brief Reset an MPSC queue
+ * 
+ * @note Not lock-free: no producer or consumer may be active.
+ *
+ * @param obj an MPSC queue object
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_MPSC_Reset(MicroOSQueue_MPSC_t *obj);
+
+/**
+ * @brief Init a byte stream with user-provided storage
+ * 
+ * @note Streams declared with MICROOSQUEUE_DEFINE_STREAM() are ready to use without this call.
+ *
+ * @param obj a stream object
+ * @param buffer Storage
+ * @param size Storage size in bytes (a power of two takes the mask fast path)
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_Stream_Init(MicroOSQueue_Stream_t *obj, void *buffer, uint32_t size);
+
+/**
+ * @brief Get the largest contiguous writable region (producer only)
+ * 
+ * @param obj a stream object
+ * @param region Receives the start of the region, e.g. a DMA destination address
+ * @return size_t Region length in bytes, 0 when full
+ */
+size_t MicroOSQueue_Stream_WriteRegion(MicroOSQueue_Stream_t *obj, uint8_t **region);
+
+/**
+ * @brief Publish bytes written into the region from MicroOSQueue_Stream_WriteRegion() (producer only)
+ * 
+ * @param obj a stream object
+ * @param len Number of bytes written, at most the region length
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_Stream_CommitWrite(MicroOSQueue_Stream_t *obj, size_t len);
+
+/**
+ * @brief Get the largest contiguous readable region (consumer only)
+ * 
+ * @param obj a stream object
+ * @param region Receives the start of the readable bytes
+ * @return size_t Region length in bytes, 0 when empty
+ */
+size_t MicroOSQueue_Stream_ReadRegion(MicroOSQueue_Stream_t *obj, const uint8_t **region);
+
+/**
+ * @brief Return consumed bytes to the producer (consumer only)
+ * 
+ * @param obj a stream object
+ * @param len Number of bytes consumed, at most the readable length
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_Stream_ReleaseRead(MicroOSQueue_Stream_t *obj, size_t len);
+
+/**
+ * @brief Number of bytes waiting to be read
+ * 
+ * @param obj a stream object
+ * @return size_t 
+ */
+size_t MicroOSQueue_Stream_Used(MicroOSQueue_Stream_t *obj);
+
+/**
+ * @brief Reset a byte stream
+ * 
+ * @note Not lock-free: neither the producer nor the consumer may be active.
+ *
+ * @param obj a stream object
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_Stream_Reset(MicroOSQueue_Stream_t *obj);
+
+/**
+ * @brief Init a priority queue over count already initialized level queues
+ * 
+ * @note Queues declared with MICROOSQUEUE_DEFINE_PRIO() are ready to use without this call.
+ *
+ * @param obj a priority queue object
+ * @param levels Level queues, levels[0] is the most urgent; the array must outlive obj
+ * @param count Number of levels, 1 .. MICROOSQUEUE_PRIO_LEVELS_MAX
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_Prio_Init(MicroOSQueue_Prio_t *obj, MicroOSQueue_Obj_t *const *levels, uint8_t count);
+
+/**
+ * @brief Push a message at a priority level (the level's single producer only)
+ * 
+ * @note The level's overflow policy applies, see MicroOSQueue_SetPolicy().
+ *
+ * @param obj a priority queue object
+ * @param prio Level, 0 is the most urgent
+ * @param data Message data
+ * @param size Message length
+ * @return MicroOS_Status_t MICROOS_INVALID_PARAM when prio is out of range
+ */
+MicroOS_Status_t MicroOSQueue_Prio_Push(MicroOSQueue_Prio_t *obj,uint8_t prio,const void *data,size_t size);
+
+/**
+ * @brief Read the oldest message of the most urgent non-empty level in place (consumer only)
+ * 
+ * @note Until it is released, peeking again returns the same message even if a
+ *       more urgent one has arrived meanwhile.
+ *
+ * @param obj a priority queue object
+ * @param msg Receives a pointer to the message, valid until MicroOSQueue_Prio_Release()
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_Prio_Peek(MicroOSQueue_Prio_t *obj,const MicroOSQueue_Message_t **msg);
+
+/**
+ * @brief Drop the message obtained with MicroOSQueue_Prio_Peek() (consumer only)
+ * 
+ * @param obj a priority queue object
+ * @return MicroOS_Status_t MICROOS_QUEUE_EMPTY when nothing was peeked
+ */
+MicroOS_Status_t MicroOSQueue_Prio_Release(MicroOSQueue_Prio_t *obj);
+
+/**
+ * @brief Read up to count messages of the most urgent non-empty level in place (consumer only)
+ * 
+ * @note A batch never mixes levels; more urgent messages are picked up by the next batch.
+ *
+ * @param obj a priority queue object
+ * @param msgs Receives count message pointers, valid until MicroOSQueue_Prio_ReleaseN()
+ * @param count Maximum number of messages
+ * @return uint32_t Number of messages returned
+ */
+uint32_t MicroOSQueue_Prio_PeekN(MicroOSQueue_Prio_t *obj,const MicroOSQueue_Message_t **msgs,uint32_t count);
+
+/**
+ * @brief Drop up to count messages obtained with MicroOSQueue_Prio_PeekN() (consumer only)
+ * 
+ * @param obj a priority queue object
+ * @param count Number of messages
+ * @return uint32_t Number of messages dropped
+ */
+uint32_t MicroOSQueue_Prio_ReleaseN(MicroOSQueue_Prio_t *obj,uint32_t count);
+
+/**
+ * @brief no level of the priority queue holds a message
+ * 
+ * @param obj a priority queue object
+ * @return true is empty
+ * @return false not empty
+ */
+bool MicroOSQueue_Prio_IsEmpty(MicroOSQueue_Prio_t *obj);
+
+/**
+ * @brief Reset a priority queue and all of its levels
+ * 
+ * @note Not lock-free: no producer or consumer may be active.
+ *
+ * @param obj a priority queue object
+ * @return MicroOS_Status_t 
+ */
+MicroOS_Status_t MicroOSQueue_Prio_Reset(MicroOSQueue_Prio_t *obj);
+
 #ifdef __cplusplus
 }
 #endif
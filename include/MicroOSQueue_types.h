@@ -12,6 +12,7 @@
 #define MicroOSQueue_TYPES_H
 
 #include "MicroOS_conf.h"
+#include "stdbool.h"
 #include "stdint.h"
 #include "string.h"
 
@@ -21,30 +22,248 @@ extern "C"
 #endif
 
 /**
- * @brief Statically allocated, copy-based byte ring buffer.
+ * @brief Statically allocated, copy-based message queue.
  *
- * @note Each stored item is framed with a length header (see
- *       MicroOSQueue.h / MicroOSQueue_LEN_BYTES) so that variable-length
- *       items can share the same raw buffer without losing their
- *       boundaries.
+ * @note Single producer / single consumer lock-free: one context (e.g. an ISR
+ *       or another core) may push while another pops, without masking
+ *       interrupts. tail and head are published with release stores and read
+ *       with acquire loads; each side caches the other side's index and only
+ *       re-reads it when the cached value says full (producer) or empty
+ *       (consumer). Several producers must not share one queue.
+ *
+ * @note Messages are length-framed records in a byte ring: each one takes a
+ *       size_t header plus its actual payload (size_t aligned), not a full
+ *       msg_size slot, so mixed-size traffic packs far more messages into the
+ *       same RAM. A record never straddles the end of the buffer; when the tail
+ *       space is too short a wrap marker is written and the record starts at
+ *       offset 0, so every message can be read in place as one contiguous block.
  */
 
+/**
+ * @brief A queued message: length header followed by the payload.
+ */
 typedef struct 
 {
     size_t len;
-    uint8_t data[MICROOS_QUEUE_SINGLE_MSG_SIZE];
+    uint8_t data[];
 } MicroOSQueue_Message_t;
 
+/** Bytes taken in the ring by one message of msg_size bytes (header + payload, size_t aligned) */
+#define MICROOSQUEUE_SLOT_SIZE(msg_size) \
+    ((sizeof(MicroOSQueue_Message_t) + (msg_size) + sizeof(size_t) - 1U) / sizeof(size_t) * sizeof(size_t))
+
+/**
+ * Storage size in bytes that guarantees room for depth messages of msg_size bytes.
+ * One extra record covers the padding lost at the end of the buffer on wrap;
+ * shorter messages take proportionally less, so more of them fit.
+ */
+#define MICROOSQUEUE_STORAGE_SIZE(depth, msg_size) (((depth) + 1U) * MICROOSQUEUE_SLOT_SIZE(msg_size))
+
+/** Overflow policies, see MicroOSQueue_SetPolicy() */
+#define MICROOSQUEUE_POLICY_REJECT            0U  // return MICROOS_QUEUE_FULL and count a drop (default)
+#define MICROOSQUEUE_POLICY_DROP_NEWEST       1U  // discard the new message, return MICROOS_OK, count a drop
+#define MICROOSQUEUE_POLICY_OVERWRITE_OLDEST  2U  // discard the oldest messages to make room
+
+/** Largest buffer for MICROOSQUEUE_POLICY_OVERWRITE_OLDEST: positions run to 2*size and bit 31 marks a held head */
+#define MICROOSQUEUE_OVERWRITE_SIZE_MAX       0x40000000UL
+
+/**
+ * @brief Per-queue counters, see MicroOSQueue_GetStats()
+ */
+typedef struct
+{
+    uint32_t Pushes;        // messages accepted
+    uint32_t Pops;          // messages consumed
+    uint32_t Drops;         // new messages rejected or discarded because the queue was full
+    uint32_t Overwrites;    // old messages discarded by MICROOSQUEUE_POLICY_OVERWRITE_OLDEST
+    uint32_t HighWater;     // most messages held at once
+} MicroOSQueue_Stats_t;
+
+#if MICROOS_QUEUE_STATS_ENABLE
+#define MICROOSQUEUE_STATS_INITIALIZER , {0U, 0U, 0U, 0U, 0U}
+#else
+#define MICROOSQUEUE_STATS_INITIALIZER
+#endif
+
+/** Offset mask for a power-of-two capacity, 0 otherwise (generic compare-and-subtract path) */
+#define MICROOSQUEUE_MASK(size) ((((size) & ((size) - 1U)) == 0U) ? (size) - 1U : 0U)
 
 typedef struct
 {
-    MicroOSQueue_Message_t buffer[MICROOS_QUEUE_DEPTH];
+    uint8_t *buffer;        // byte ring storage
+    uint32_t size;          // ring capacity in bytes
+    uint32_t mask;          // size - 1 when size is a power of two, else 0
+    uint32_t msg_size;      // maximum payload of a single message
+
+    // producer side: only the producer writes tail and head_cache
+    volatile uint32_t tail; // write position, counts in [0, 2 * size)
+    uint32_t head_cache;    // last head seen by the producer
+    uint32_t reserved;      // payload bytes claimed by the open MicroOSQueue_Reserve()
+
+    // consumer side: only the consumer writes head and tail_cache
+    volatile uint32_t head; // read position, counts in [0, 2 * size); top bit set while the consumer holds a message (overwrite policy)
+    uint32_t tail_cache;    // last tail seen by the consumer
 
-    volatile uint32_t tail;
-    volatile uint32_t head;
+    uint8_t policy;         // MICROOSQUEUE_POLICY_xxx, zero (reject) by default
+    bool reserving;         // a MicroOSQueue_Reserve() waits for its MicroOSQueue_Commit() (producer)
+#if MICROOS_QUEUE_STATS_ENABLE
+    MicroOSQueue_Stats_t stats;
+#endif
 
 } MicroOSQueue_Obj_t;
 
+/** Static initializer for a queue on user-provided, size_t aligned storage of size bytes */
+#define MICROOSQUEUE_INITIALIZER(storage, size, msg_size) \
+    {(uint8_t *)(storage), (size), MICROOSQUEUE_MASK(size), (msg_size), 0U, 0U, 0U, 0U, 0U, \
+     MICROOSQUEUE_POLICY_REJECT, false MICROOSQUEUE_STATS_INITIALIZER}
+
+/**
+ * @brief Define a queue object together with its storage.
+ *
+ * @param name Queue object name
+ * @param depth Number of maximum-size messages guaranteed to fit
+ * @param msg_size Maximum payload of a single message (bytes)
+ */
+#define MICROOSQUEUE_DEFINE(name, depth, msg_size)                                                \
+    static size_t name##_storage[MICROOSQUEUE_STORAGE_SIZE(depth, msg_size) / sizeof(size_t)]; \
+    static MicroOSQueue_Obj_t name = MICROOSQUEUE_INITIALIZER(name##_storage, MICROOSQUEUE_STORAGE_SIZE(depth, msg_size), msg_size)
+
+/**
+ * @brief Multi-producer / single-consumer fixed-slot message queue.
+ *
+ * @note Producers claim a slot with a CAS on tail and publish it through the
+ *       slot's sequence word, so any number of ISRs (at any priority) or cores
+ *       may push concurrently without masking interrupts. Each slot holds a
+ *       sequence word followed by a MicroOSQueue_Message_t of up to msg_size
+ *       bytes. The sequence word stores the lap base (pos & ~mask) when the slot
+ *       is free for pos and lap base + 1 once filled, so zeroed storage is a
+ *       valid empty queue. depth must be a power of two, at least 2.
+ */
+
+/** Slot stride of an MPSC queue (sequence word + message slot) */
+#define MICROOSQUEUE_MPSC_SLOT_SIZE(msg_size) (sizeof(size_t) + MICROOSQUEUE_SLOT_SIZE(msg_size))
+
+/** Storage size in bytes of an MPSC queue of depth messages of up to msg_size bytes */
+#define MICROOSQUEUE_MPSC_STORAGE_SIZE(depth, msg_size) ((depth) * MICROOSQUEUE_MPSC_SLOT_SIZE(msg_size))
+
+typedef struct
+{
+    uint8_t *buffer;        // depth slots of slot_size bytes
+    uint32_t mask;          // depth - 1
+    uint32_t msg_size;      // maximum payload of a single message
+    uint32_t slot_size;     // slot stride
+
+    volatile uint32_t tail; // next position to claim (producers, CAS)
+    uint32_t head;          // next position to read (consumer only)
+
+    uint8_t policy;         // MICROOSQUEUE_POLICY_REJECT or _DROP_NEWEST
+#if MICROOS_QUEUE_STATS_ENABLE
+    MicroOSQueue_Stats_t stats;
+#endif
+
+} MicroOSQueue_MPSC_t;
+
+/** Static initializer for an MPSC queue on zeroed, size_t aligned storage */
+#define MICROOSQUEUE_MPSC_INITIALIZER(storage, depth, msg_size) \
+    {(uint8_t *)(storage), (depth) - 1U, (msg_size), MICROOSQUEUE_MPSC_SLOT_SIZE(msg_size), 0U, 0U, \
+     MICROOSQUEUE_POLICY_REJECT MICROOSQUEUE_STATS_INITIALIZER}
+
+/**
+ * @brief Define an MPSC queue object together with its storage.
+ *
+ * @param name Queue object name
+ * @param depth Number of messages, a power of two (>= 2)
+ * @param msg_size Maximum payload of a single message (bytes)
+ */
+#define MICROOSQUEUE_DEFINE_MPSC(name, depth, msg_size)                                                     \
+    typedef char name##_depth_must_be_pow2[((depth) >= 2U && ((depth) & ((depth) - 1U)) == 0U) ? 1 : -1]; \
+    static size_t name##_storage[MICROOSQUEUE_MPSC_STORAGE_SIZE(depth, msg_size) / sizeof(size_t)];       \
+    static MicroOSQueue_MPSC_t name = MICROOSQUEUE_MPSC_INITIALIZER(name##_storage, depth, msg_size)
+
+/**
+ * @brief Unframed single-producer / single-consumer byte stream for DMA.
+ *
+ * @note The producer asks for the largest contiguous writable region, lets a
+ *       DMA engine (or a driver) fill it directly, then commits the byte count.
+ *       The consumer reads the largest contiguous readable region in place and
+ *       releases what it consumed. No byte is copied by the queue itself.
+ *       Positions count in [0, 2 * size) like MicroOSQueue_Obj_t; any size works,
+ *       a power of two takes the mask fast path.
+ */
+typedef struct
+{
+    uint8_t *buffer;        // byte storage
+    uint32_t size;          // capacity in bytes
+    uint32_t mask;          // size - 1 when size is a power of two, else 0
+
+    volatile uint32_t tail; // write position (producer)
+    volatile uint32_t head; // read position (consumer)
+
+} MicroOSQueue_Stream_t;
+
+/** Static initializer for a stream on user-provided storage of size bytes */
+#define MICROOSQUEUE_STREAM_INITIALIZER(storage, size) \
+    {(uint8_t *)(storage), (size), MICROOSQUEUE_MASK(size), 0U, 0U}
+
+/**
+ * @brief Define a stream object together with its storage.
+ *
+ * @param name Stream object name
+ * @param size Capacity in bytes
+ */
+#define MICROOSQUEUE_DEFINE_STREAM(name, size)   \
+    static uint8_t name##_storage[(size)];        \
+    static MicroOSQueue_Stream_t name = MICROOSQUEUE_STREAM_INITIALIZER(name##_storage, size)
+
+/**
+ * @brief Priority message queue: one MicroOSQueue_Obj_t ring per level plus a non-empty bitmap.
+ *
+ * @note Level 0 is the most urgent. Push and pop are O(1): a push sets the
+ *       level's bit in ready, the consumer picks the most urgent set bit with
+ *       one count-leading-zeros and clears it when that level runs dry. Each
+ *       level is its own SPSC ring, so different levels may be fed by different
+ *       producers (e.g. a fault ISR on level 0, the main loop on level 2), but
+ *       one level must not have more than one producer. Messages must be pushed
+ *       through MicroOSQueue_Prio_Push(), never directly into a level.
+ */
+
+/** Maximum number of priority levels (one bit each in the ready bitmap) */
+#define MICROOSQUEUE_PRIO_LEVELS_MAX 32U
+
+typedef struct
+{
+    MicroOSQueue_Obj_t *const *levels;  // level rings, most urgent first
+    uint8_t count;                      // number of levels
+
+    volatile uint32_t ready;            // MICROOS_BIT(level) set while the level may hold messages
+    uint8_t current;                    // level of the last Peek/PeekN (consumer only)
+    uint8_t held;                       // a Peek/PeekN on current has not been released yet
+
+} MicroOSQueue_Prio_t;
+
+/** Number of entries of an array */
+#define MICROOSQUEUE_COUNT_OF(array) (sizeof(array) / sizeof((array)[0]))
+
+/** Static initializer for a priority queue over an array of count level queues */
+#define MICROOSQUEUE_PRIO_INITIALIZER(levels, count) {(levels), (count), 0U, 0U, 0U}
+
+/**
+ * @brief Define a priority queue over existing queues, most urgent first.
+ *
+ * @note Each level keeps its own depth and policy, e.g. a small urgent level
+ *       and a deep routine one:
+ *       MICROOSQUEUE_DEFINE(fault_q, 4, 16);
+ *       MICROOSQUEUE_DEFINE(telemetry_q, 32, 16);
+ *       MICROOSQUEUE_DEFINE_PRIO(ctrl_q, &fault_q, &telemetry_q);
+ *
+ * @param name Priority queue object name
+ * @param ... Addresses of the level queues, level 0 first
+ */
+#define MICROOSQUEUE_DEFINE_PRIO(name, ...)                                                                               \
+    static MicroOSQueue_Obj_t *const name##_levels[] = {__VA_ARGS__};                                                     \
+    typedef char name##_too_many_levels[(MICROOSQUEUE_COUNT_OF(name##_levels) <= MICROOSQUEUE_PRIO_LEVELS_MAX) ? 1 : -1]; \
+    static MicroOSQueue_Prio_t name = MICROOSQUEUE_PRIO_INITIALIZER(name##_levels, (uint8_t)MICROOSQUEUE_COUNT_OF(name##_levels))
+
 #ifdef __cplusplus
 }
 #endif
@@ -54,6 +54,25 @@ extern "C"
         }                                 \
     } while (0)
 
+// Atomic helpers (GCC/Clang __atomic builtins, C11 memory model).
+// On Cortex-M3/M4/M7 these compile to LDREX/STREX loops, no IRQ masking needed.
+#define MICROOS_ATOMIC_LOAD(ptr)            __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define MICROOS_ATOMIC_STORE(ptr, val)      __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#define MICROOS_ATOMIC_EXCHANGE(ptr, val)   __atomic_exchange_n((ptr), (val), __ATOMIC_ACQ_REL)
+#define MICROOS_ATOMIC_FETCH_ADD(ptr, val)  __atomic_fetch_add((ptr), (val), __ATOMIC_ACQ_REL)
+#define MICROOS_ATOMIC_FETCH_SUB(ptr, val)  __atomic_fetch_sub((ptr), (val), __ATOMIC_ACQ_REL)
+#define MICROOS_ATOMIC_FETCH_OR(ptr, val)   __atomic_fetch_or((ptr), (val), __ATOMIC_ACQ_REL)
+#define MICROOS_ATOMIC_FETCH_AND(ptr, val)  __atomic_fetch_and((ptr), (val), __ATOMIC_ACQ_REL)
+#define MICROOS_ATOMIC_FENCE()              __atomic_thread_fence(__ATOMIC_SEQ_CST)
+// Weak CAS: on failure *(expected) is refreshed with the current value
+#define MICROOS_ATOMIC_CAS(ptr, expected, desired) \
+    __atomic_compare_exchange_n((ptr), (expected), (desired), true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+// Bitmap helpers: index 0 is the MSB so that MICROOS_CLZ() returns the lowest index first.
+// MICROOS_CLZ(0) is undefined, always test the word first.
+#define MICROOS_BIT(i) (0x80000000UL >> ((i) & 31U))
+#define MICROOS_CLZ(x) ((uint8_t)__builtin_clz(x))
+
 #ifdef __cplusplus
 }
 #endif
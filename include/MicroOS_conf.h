@@ -52,6 +52,37 @@ extern "C"
 /** Maximum number of registered events */
 #define MICROOS_EVENT_POOL_SIZE               10U
 
+/** Number of event priority levels, 0 is the highest (max 32) */
+#define MICROOS_EVENT_PRIORITY_NUM            8U
+
+/** Re-select the highest pending priority after every event callback (0: Disable, 1: Enable) */
+#define MICROOS_EVENT_PRIORITY_RECHECK        1U
+
+
+/*==============================================================================
+ * Event Group Module
+ *============================================================================*/
+
+/** Enable Event Group module (0: Disable, 1: Enable) */
+#define MICROOS_EVENTGROUP_ENABLE             1U
+
+/** Maximum number of event groups (max 32) */
+#define MICROOS_EVENTGROUP_SIZE               4U
+
+
+/*==============================================================================
+ * Deferred Call Module
+ *============================================================================*/
+
+/** Enable Deferred Call module (0: Disable, 1: Enable) */
+#define MICROOS_DEFER_ENABLE                  1U
+
+/** Deferred call ring size (power of two) */
+#define MICROOS_DEFER_QUEUE_SIZE              16U
+
+/** Maximum number of deferred calls executed per scheduler pass */
+#define MICROOS_DEFER_BATCH                   8U
+
 
 /*==============================================================================
  * Message Event Module
@@ -63,16 +94,42 @@ extern "C"
 /** Maximum number of Message Events */
 #define MICROOS_MESSAGEEVENT_SIZE             5U
 
+/**
+ * Default number of messages a Message Event may drain per scheduler pass.
+ * Change per event with MicroOS_SetMessageEventBudget().
+ */
+#define MICROOS_MESSAGEEVENT_BUDGET           1U
+
+/** Largest batch handed to a batch handler in one call (sizes a stack array of pointers) */
+#define MICROOS_MESSAGEEVENT_BATCH_MAX        8U
+
 
 /*==============================================================================
- * Queue Module
+ * RPC Module
  *============================================================================*/
 
-/** Queue depth (number of messages) */
-#define MICROOS_QUEUE_DEPTH                   5U
+/** Enable request/response calls over Message Events (0: Disable, 1: Enable), needs MICROOS_MESSAGEEVENT_ENABLE */
+#define MICROOS_RPC_ENABLE                    1U
+
+/** Maximum number of calls waiting for a reply (max 32) */
+#define MICROOS_RPC_PENDING_SIZE              4U
 
-/** Maximum payload size of a single message (bytes) */
-#define MICROOS_QUEUE_SINGLE_MSG_SIZE         8U
+/** Largest request payload (sizes a stack buffer in MicroOS_RpcCall()) */
+#define MICROOS_RPC_REQUEST_SIZE              32U
+
+/** Largest reply payload, stored in the pending call until the callback runs */
+#define MICROOS_RPC_REPLY_SIZE                32U
+
+/** OSdelay IDs [BASE, BASE + MICROOS_RPC_PENDING_SIZE) are reserved for call timeouts */
+#define MICROOS_RPC_OSDELAY_ID_BASE           240U
+
+
+/*==============================================================================
+ * Queue Module
+ *============================================================================*/
+
+/** Track per-queue push/pop/drop counters and high-water mark (0: Disable, 1: Enable) */
+#define MICROOS_QUEUE_STATS_ENABLE            1U
 
 
 /*==============================================================================
@@ -85,8 +142,70 @@ extern "C"
 /** Maximum number of topics */
 #define MICROOS_TOPIC_SIZE                    5U
 
-/** Maximum number of subscribers per topic */
-#define MICROOS_SUBSCRIBER_NUM                3U
+/** Subscribers shared by all topics, allocated on subscribe (at most 254) */
+#define MICROOS_SUBSCRIBER_POOL_SIZE          16U
+
+/** Allow topics to queue samples in a broadcast ring with per-subscriber cursors (0: Disable, 1: Enable) */
+#define MICROOS_TOPIC_RING_ENABLE             1U
+
+/** Attempts to copy a retained topic value before giving up with MICROOS_BUSY */
+#define MICROOS_TOPIC_READ_RETRIES            8U
+
+/** Resolve topics by name through a hash table (0: Disable, 1: Enable) */
+#define MICROOS_TOPIC_HASH_ENABLE             1U
+
+/** Hash table slots, a power of two larger than MICROOS_TOPIC_SIZE */
+#define MICROOS_TOPIC_HASH_SIZE               8U
+
+/** Allow wildcard subscriptions on '/' separated topic names (0: Disable, 1: Enable) */
+#define MICROOS_TOPIC_PATTERN_ENABLE          1U
+
+/** Maximum number of wildcard subscriptions (at most 32) */
+#define MICROOS_TOPIC_PATTERN_SIZE            4U
+
+/** Per-subscriber predicates and per-topic on-change suppression (0: Disable, 1: Enable) */
+#define MICROOS_TOPIC_FILTER_ENABLE           1U
+
+/** Per-subscriber minimum interval and decimation (0: Disable, 1: Enable) */
+#define MICROOS_TOPIC_RATE_ENABLE             1U
+
+/** Call the subscribers of a topic in priority order, 0 is the highest (0: Disable, 1: Enable) */
+#define MICROOS_TOPIC_PRIORITY_ENABLE         1U
+
+/** Priority given to new subscribers, change with MicroOS_SetSubscriberPriority() */
+#define MICROOS_SUBSCRIBER_PRIORITY_DEFAULT   128U
+
+/**
+ * Default number of subscriber callbacks a topic may run per scheduler pass, 0 for no limit.
+ * Change per topic with MicroOS_SetTopicBudget().
+ */
+#define MICROOS_TOPIC_BUDGET                  0U
+
+
+/*==============================================================================
+ * Bridge Module
+ *============================================================================*/
+
+/** Enable the topic bridge to a byte-stream link (0: Disable, 1: Enable), needs MICROOS_SUBSCRIPTION_ENABLE */
+#define MICROOS_BRIDGE_ENABLE                 1U
+
+/** Topics a bridge can export */
+#define MICROOS_BRIDGE_EXPORT_NUM             4U
+
+/** Channels a bridge can import */
+#define MICROOS_BRIDGE_IMPORT_NUM             4U
+
+/** Largest frame payload in bytes, several samples per frame (at most 255) */
+#define MICROOS_BRIDGE_FRAME_MAX              128U
+
+/** Remote nodes tracked for duplicate frame rejection */
+#define MICROOS_BRIDGE_PEER_NUM               4U
+
+/** Frames a bridge may receive per MicroOSBridge_Poll() */
+#define MICROOS_BRIDGE_RX_BUDGET              4U
+
+/** Subscriber id the bridge takes on exported topics */
+#define MICROOS_BRIDGE_SUB_ID                 0xFEU
 
 
 #ifdef __cplusplus
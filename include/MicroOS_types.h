@@ -15,6 +15,7 @@
 #include "stdbool.h"
 #include "MicroOS_conf.h"
 #include "MicroOSQueue_types.h"
+#include "MicroOSPool_types.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -33,6 +34,19 @@ typedef void (*MicroOS_TaskFunction_t)(void *Userdata);
  */
 typedef void (*MicroOS_EventFunction_t)(void *Userdata);
 
+/**
+ * @brief Batch event function prototype
+ * @param Userdata Pointer to user data
+ * @param count Number of triggers since the previous call
+ */
+typedef void (*MicroOS_BatchEventFunction_t)(void *Userdata, uint32_t count);
+
+/**
+ * @brief Deferred call function prototype
+ * @param arg Argument passed to MicroOS_Defer()
+ */
+typedef void (*MicroOS_DeferFunction_t)(void *arg);
+
 /**
  * @brief OSdelay function prototype
  * @param Userdata Pointer to user data
@@ -46,6 +60,14 @@ typedef void (*MicroOS_OSdelayFunction_t)(void *Userdata);
  */
 typedef void (*MicroOSQueue_EventFunction_t)(const MicroOSQueue_Message_t* QueueMsg);
 
+/**
+ * @brief Batched EventQueue function prototype
+ * @param QueueMsgs Messages in arrival order, pointing into the queue
+ * @param count Number of messages
+ * 
+ */
+typedef void (*MicroOSQueue_BatchFunction_t)(const MicroOSQueue_Message_t *const *QueueMsgs, uint32_t count);
+
 typedef void (*MicroOS_SubscriberFunction_t)(void *Userdata);
 /**
  * @brief MicroOS status codes
@@ -123,15 +145,32 @@ typedef struct MicroOS_Event_Sub_t
     char *name;                     // event name
     bool IsRunning;                 // Whether to run
     bool IsUsed;                    // Whether to used
-    volatile bool Triggered;     // riggers
+    uint8_t Priority;               // 0 = highest
+    volatile uint32_t TriggerCount; // triggers not yet dispatched
     void (*EventFunction)(void* data);
+    void (*BatchFunction)(void *data, uint32_t count);
+#if MICROOS_EVENTGROUP_ENABLE
+    bool IsGroupWaiter;             // Whether bound to an event group
+    uint8_t Group;                  // bound event group id
+    uint8_t WaitOptions;            // MICROOS_EVENTGROUP_WAIT_xxx | MICROOS_EVENTGROUP_AUTO_CLEAR
+    uint32_t WaitMask;              // event group bits waited for
+#endif
     void *Userdata;
     struct MicroOS_Event_Sub_t *next; // next node
 } MicroOS_Event_Sub_t;
 
+/** Number of 32-bit words in the pending-event bitmap */
+#define MICROOS_EVENT_MAP_WORDS ((MICROOS_EVENT_POOL_SIZE + 31U) / 32U)
+
+#if MICROOS_EVENT_PRIORITY_NUM > 32U
+#error "MICROOS_EVENT_PRIORITY_NUM must not exceed 32"
+#endif
+
 typedef struct
 {
     MicroOS_Event_Sub_t EventPools[MICROOS_EVENT_POOL_SIZE]; // event pool
+    volatile uint32_t PendingMap[MICROOS_EVENT_PRIORITY_NUM][MICROOS_EVENT_MAP_WORDS]; // triggered events per priority, pool slot i -> MICROOS_BIT(i)
+    volatile uint32_t PendingLevels;                                                   // priorities with triggered events, priority p -> MICROOS_BIT(p)
     MicroOS_Event_Sub_t *free_event;                   // idle events
     MicroOS_Event_Sub_t *active_event;                 // active events
     uint8_t CurrentEventId;                            // Current event ID
@@ -139,14 +178,73 @@ typedef struct
     // MicroOSQueue_Obj_t Event_queue;                     // Event queue
 } MicroOS_Event_t;
 
+#if MICROOS_EVENTGROUP_ENABLE
+#if MICROOS_EVENTGROUP_SIZE > 32U
+#error "MICROOS_EVENTGROUP_SIZE must not exceed 32"
+#endif
+
+/** Event group wait options */
+#define MICROOS_EVENTGROUP_WAIT_ANY   0x00U /**< Fire when any bit of the mask is set (OR) */
+#define MICROOS_EVENTGROUP_WAIT_ALL   0x01U /**< Fire when every bit of the mask is set (AND) */
+#define MICROOS_EVENTGROUP_AUTO_CLEAR 0x02U /**< Clear the mask bits that fired it */
+
+typedef struct
+{
+    bool IsUsed;
+    char *name;
+    volatile uint32_t Bits;                          // event bits
+    uint32_t WaiterMap[MICROOS_EVENT_MAP_WORDS];     // waiting events, pool slot i -> MICROOS_BIT(i)
+} MicroOS_EventGroup_Sub_t;
+
+typedef struct
+{
+    // O(1) 查找：数组下标就是 ID
+    MicroOS_EventGroup_Sub_t Groups[MICROOS_EVENTGROUP_SIZE];
+    volatile uint32_t PendingGroups;                 // groups whose bits were set, group i -> MICROOS_BIT(i)
+} MicroOS_EventGroup_t;
+#endif
+
+#if MICROOS_DEFER_ENABLE
+#if (MICROOS_DEFER_QUEUE_SIZE & (MICROOS_DEFER_QUEUE_SIZE - 1U)) != 0U
+#error "MICROOS_DEFER_QUEUE_SIZE must be a power of two"
+#endif
+
+typedef struct
+{
+    volatile uint32_t seq;          // slot sequence: pos = free, pos + 1 = filled
+    MicroOS_DeferFunction_t DeferFunction;
+    void *arg;
+} MicroOS_Defer_Sub_t;
+
+typedef struct
+{
+    MicroOS_Defer_Sub_t ring[MICROOS_DEFER_QUEUE_SIZE];
+    volatile uint32_t tail;         // next slot to claim (producers, CAS)
+    uint32_t head;                  // next slot to run (scheduler only)
+    volatile uint32_t Dropped;      // calls rejected because the ring was full
+} MicroOS_Defer_t;
+#endif
+
+/** Message Event queue types */
+#define MICROOS_MSGQUEUE_SPSC 0U
+#define MICROOS_MSGQUEUE_MPSC 1U
+#define MICROOS_MSGQUEUE_PRIO 2U
+
 typedef struct {
     // (O1)查找,数组索引就是ID，因为消息需要memecpy就已经很重了，如果再加个O(n),会浪费cpu
     bool IsUsed;                  // Indicates if the task is currently in use
     bool IsRunning;               // Indicates if the task is currently running
     char *name;                   // Task name
     void (*MessageEventFunction)(const MicroOSQueue_Message_t *);
-    MicroOSQueue_Message_t Userdata;               // Pointer to user data
-    MicroOSQueue_Obj_t queue;
+    MicroOSQueue_BatchFunction_t BatchFunction; // optional, replaces MessageEventFunction when set
+    uint8_t Budget;               // messages drained per scheduler pass
+    uint8_t QueueType;            // MICROOS_MSGQUEUE_SPSC / _MPSC / _PRIO
+    union {
+        MicroOSQueue_Obj_t *spsc;     // single producer (one ISR or task)
+        MicroOSQueue_MPSC_t *mpsc;    // several ISRs / cores trigger concurrently
+        MicroOSQueue_Prio_t *prio;    // urgent messages overtake the backlog
+    } queue;                      // user-declared queue, sized per event
+    MicroOSPool_t *Pool;          // set: the queue carries references to pooled blocks instead of payloads
 }MicroOS_MessageEvent_Sub_t;
 
 typedef struct
@@ -155,14 +253,283 @@ typedef struct
     uint32_t MaxMessage;                           /**< Maximum number of Message supported */
     uint8_t CurrentMessageEventId;               /**< Current running Message ID */
     uint8_t MessageNum;                             /**< Number of Message added */
+    bool Dispatching;                               /**< A handler of CurrentMessageEventId is running */
+    bool CurrentDeleted;                            /**< That handler deleted its own event */
+    MicroOS_MessageEvent_Sub_t Deleted;             /**< The deleted event's queue, drained once its handler returns */
 } MicroOS_MessageEvent_t;
 
+#if MICROOS_RPC_ENABLE
+#if !MICROOS_MESSAGEEVENT_ENABLE
+#error "MICROOS_RPC_ENABLE needs MICROOS_MESSAGEEVENT_ENABLE"
+#endif
+
+#if MICROOS_RPC_PENDING_SIZE > 32U
+#error "MICROOS_RPC_PENDING_SIZE must not exceed 32"
+#endif
+
+#if MICROOS_RPC_OSDELAY_ID_BASE + MICROOS_RPC_PENDING_SIZE > 256U
+#error "MICROOS_RPC_OSDELAY_ID_BASE + MICROOS_RPC_PENDING_SIZE must fit in an OSdelay ID"
+#endif
+
+/**
+ * @brief RPC completion callback
+ * @param status MICROOS_OK with the reply, or MICROOS_TIMEOUT
+ * @param reply Reply payload, valid for the duration of the call (NULL on timeout)
+ * @param reply_len Reply length
+ * @param arg Argument passed to MicroOS_RpcCall()
+ */
+typedef void (*MicroOS_RpcCallback_t)(MicroOS_Status_t status, const void *reply, size_t reply_len, void *arg);
+
+/** Bytes in front of every request payload: the call ID */
+#define MICROOS_RPC_HEADER_SIZE sizeof(uint32_t)
+
+/** Pending call states, low two bits of MicroOS_RpcCall_Sub_t::State */
+#define MICROOS_RPC_FREE      0U
+#define MICROOS_RPC_PENDING   1U
+#define MICROOS_RPC_REPLYING  2U
+#define MICROOS_RPC_DONE      3U
+
+typedef struct
+{
+    volatile uint32_t State;            // generation << 2 | MICROOS_RPC_xxx, claimed by CAS
+    MicroOS_RpcCallback_t Callback;
+    void *arg;
+    size_t ReplyLen;
+    uint8_t Reply[MICROOS_RPC_REPLY_SIZE];
+} MicroOS_RpcCall_Sub_t;
+
+typedef struct
+{
+    // O(1) 查找: 调用 ID 的低 8 位就是下标, 其余位是代数, 防止迟到的回复匹配到新的调用
+    MicroOS_RpcCall_Sub_t Calls[MICROOS_RPC_PENDING_SIZE];
+    uint32_t FreeMap;                   // idle slots, slot i -> MICROOS_BIT(i) (scheduler only)
+    volatile uint32_t DoneMap;          // slots holding a reply for the callback, slot i -> MICROOS_BIT(i)
+    uint32_t Generation;                // bumped per call, never 0
+} MicroOS_Rpc_t;
+#endif
+
+/** 32-bit FNV-1a, see MicroOS_TopicHash() and MicroOS_SetTopicOnChange() */
+#define MICROOS_FNV1A_OFFSET                  2166136261U
+#define MICROOS_FNV1A_PRIME                   16777619U
+
+#if MICROOS_TOPIC_HASH_ENABLE
+#if (MICROOS_TOPIC_HASH_SIZE & (MICROOS_TOPIC_HASH_SIZE - 1U)) != 0U || MICROOS_TOPIC_HASH_SIZE <= MICROOS_TOPIC_SIZE
+#error "MICROOS_TOPIC_HASH_SIZE must be a power of two larger than MICROOS_TOPIC_SIZE"
+#endif
+
+/** Longest topic name MICROOS_TOPIC_HASH() accepts */
+#define MICROOS_TOPIC_HASH_NAME_MAX           32U
+
+// One FNV-1a round per character. Past the end of the name the round becomes
+// (h ^ 0) * 1, so h appears once per round and the expansion stays linear.
+#define MICROOS_TOPIC_HASH_ACTIVE(s, i) ((i) < sizeof(s) - 1U)
+#define MICROOS_TOPIC_HASH_STEP(h, s, i)                                                                 \
+    ((uint32_t)(((h) ^ (MICROOS_TOPIC_HASH_ACTIVE(s, i) ? (uint32_t)(uint8_t)(s)[MICROOS_TOPIC_HASH_ACTIVE(s, i) ? (i) : 0U] : 0U)) \
+                * (MICROOS_TOPIC_HASH_ACTIVE(s, i) ? MICROOS_FNV1A_PRIME : 1U)))
+#define MICROOS_TOPIC_HASH_4(h, s, i) \
+    MICROOS_TOPIC_HASH_STEP(MICROOS_TOPIC_HASH_STEP(MICROOS_TOPIC_HASH_STEP(MICROOS_TOPIC_HASH_STEP(h, s, i), s, (i) + 1U), s, (i) + 2U), s, (i) + 3U)
+#define MICROOS_TOPIC_HASH_16(h, s, i) \
+    MICROOS_TOPIC_HASH_4(MICROOS_TOPIC_HASH_4(MICROOS_TOPIC_HASH_4(MICROOS_TOPIC_HASH_4(h, s, i), s, (i) + 4U), s, (i) + 8U), s, (i) + 12U)
+#define MICROOS_TOPIC_HASH_LITERAL(s)                                                 \
+    (MICROOS_TOPIC_HASH_16(MICROOS_TOPIC_HASH_16(MICROOS_FNV1A_OFFSET, s, 0U), s, 16U) + \
+     0U * sizeof(char[(sizeof(s) <= MICROOS_TOPIC_HASH_NAME_MAX + 1U) ? 1 : -1]))
+
+/**
+ * @brief Hash of a topic name given as a string literal, folded by the compiler.
+ *
+ * @note Equal to MicroOS_TopicHash(name). Only string literals of up to
+ *       MICROOS_TOPIC_HASH_NAME_MAX characters compile; hash runtime strings
+ *       with MicroOS_TopicHash().
+ */
+#define MICROOS_TOPIC_HASH(name) MICROOS_TOPIC_HASH_LITERAL("" name "")
+#endif
+
+#ifdef MICROOS_SUBSCRIBER_NUM
+#error "MICROOS_SUBSCRIBER_NUM is gone, size the shared pool with MICROOS_SUBSCRIBER_POOL_SIZE"
+#endif
+
+#if MICROOS_SUBSCRIBER_POOL_SIZE == 0U || MICROOS_SUBSCRIBER_POOL_SIZE > 254U
+#error "MICROOS_SUBSCRIBER_POOL_SIZE must be between 1 and 254"
+#endif
+
+#if MICROOS_TOPIC_BUDGET > 255U
+#error "MICROOS_TOPIC_BUDGET must not exceed 255"
+#endif
+
+#if MICROOS_BRIDGE_ENABLE
+#if !MICROOS_SUBSCRIPTION_ENABLE
+#error "MICROOS_BRIDGE_ENABLE needs MICROOS_SUBSCRIPTION_ENABLE"
+#endif
+
+#if MICROOS_BRIDGE_FRAME_MAX > 255U
+#error "MICROOS_BRIDGE_FRAME_MAX must not exceed 255, the frame length is a single byte"
+#endif
+
+#if MICROOS_BRIDGE_FRAME_MAX < 3U
+#error "MICROOS_BRIDGE_FRAME_MAX must hold at least one 1-byte sample"
+#endif
+#endif
+
+#if MICROOS_TOPIC_PRIORITY_ENABLE && MICROOS_SUBSCRIBER_PRIORITY_DEFAULT > 255U
+#error "MICROOS_SUBSCRIBER_PRIORITY_DEFAULT must not exceed 255"
+#endif
+
+#if MICROOS_TOPIC_PATTERN_ENABLE && MICROOS_TOPIC_PATTERN_SIZE > 32U
+#error "MICROOS_TOPIC_PATTERN_SIZE must not exceed 32"
+#endif
+
+/** Topic delivery modes, see MicroOS_SetTopicMode() */
+#define MICROOS_TOPIC_LATEST                  0U  // keep only the last Userdata pointer (default)
+#define MICROOS_TOPIC_RING                    1U  // queue copies, a lapped subscriber skips ahead and counts overruns
+#define MICROOS_TOPIC_LOSSLESS                2U  // queue copies, publishing fails while the slowest subscriber is a ring behind
+#define MICROOS_TOPIC_RETAINED                3U  // keep a copy of the last value under a sequence lock, see MicroOS_SetTopicRetained()
+
+/**
+ * @brief Broadcast ring of a queued topic.
+ *
+ * @note Every published sample is copied once into the next slot; each
+ *       subscriber keeps its own read cursor, so a slow subscriber only loses
+ *       its own samples. Sequence numbers run freely and wrap, the slot of
+ *       sequence n is n & mask. One publisher per topic (task or ISR).
+ *       In MICROOS_TOPIC_RING mode a sample is copied into the snapshot slot
+ *       after the depth slots before its callback runs, and dropped as an
+ *       overrun if the publisher reached its slot during the copy; the slot
+ *       the next publish writes is never read, so depth - 1 samples are kept.
+ */
+typedef struct
+{
+    uint8_t *buffer;            // depth slots of stride bytes, then the dispatch snapshot slot
+    uint32_t mask;              // depth - 1
+    uint32_t item_size;         // bytes copied per sample
+    uint32_t stride;            // item_size rounded up to size_t
+
+    volatile uint32_t head;     // samples published so far (publisher)
+    volatile uint32_t tail;     // oldest sample a subscriber still needs (scheduler)
+} MicroOS_TopicRing_t;
+
+/** Slot stride of a topic ring holding samples of item_size bytes */
+#define MICROOS_TOPIC_RING_STRIDE(item_size) \
+    (((item_size) + sizeof(size_t) - 1U) / sizeof(size_t) * sizeof(size_t))
+
+/** Static initializer for a topic ring on user-provided, size_t aligned storage of depth + 1 strides */
+#define MICROOS_TOPIC_RING_INITIALIZER(storage, depth, item_size) \
+    {(uint8_t *)(storage), (depth) - 1U, (item_size), MICROOS_TOPIC_RING_STRIDE(item_size), 0U, 0U}
+
+/**
+ * @brief Define a topic ring together with its storage.
+ *
+ * @param name Ring object name
+ * @param depth Number of samples, a power of two (>= 2)
+ * @param item_size Size of one sample (bytes)
+ */
+#define MICROOS_DEFINE_TOPIC_RING(name, depth, item_size)                                                 \
+    typedef char name##_depth_must_be_pow2[((depth) >= 2U && ((depth) & ((depth) - 1U)) == 0U) ? 1 : -1]; \
+    static size_t name##_storage[((depth) + 1U) * MICROOS_TOPIC_RING_STRIDE(item_size) / sizeof(size_t)]; \
+    static MicroOS_TopicRing_t name = MICROOS_TOPIC_RING_INITIALIZER(name##_storage, depth, item_size)
+
+/**
+ * @brief Retained value of a topic.
+ *
+ * @note The publisher copies each value into the first slot under a sequence
+ *       lock: seq is odd while the copy is in progress and advances by two per
+ *       publish, so a reader that sees the same even seq before and after its
+ *       copy holds a consistent value and otherwise retries. The second slot is
+ *       the snapshot handed to subscriber callbacks, written by the scheduler
+ *       only. One publisher per topic (task or ISR).
+ */
+typedef struct
+{
+    uint8_t *buffer;            // value slot, then the dispatch snapshot slot
+    uint32_t size;              // bytes copied per value
+    uint32_t stride;            // size rounded up to size_t
+
+    volatile uint32_t seq;      // 2 * values published, odd while the publisher writes
+} MicroOS_TopicValue_t;
+
+/** Static initializer for a retained value on user-provided, size_t aligned storage of two strides */
+#define MICROOS_TOPIC_VALUE_INITIALIZER(storage, size) \
+    {(uint8_t *)(storage), (size), MICROOS_TOPIC_RING_STRIDE(size), 0U}
+
+/**
+ * @brief Define a retained topic value together with its storage.
+ *
+ * @param name Value object name
+ * @param size Size of the value (bytes)
+ */
+#define MICROOS_DEFINE_TOPIC_VALUE(name, size)                                                \
+    static size_t name##_storage[2U * MICROOS_TOPIC_RING_STRIDE(size) / sizeof(size_t)]; \
+    static MicroOS_TopicValue_t name = MICROOS_TOPIC_VALUE_INITIALIZER(name##_storage, size)
+
+#if MICROOS_TOPIC_FILTER_ENABLE
+/** Subscriber predicates, see MicroOS_SetSubscriberFilter() */
+#define MICROOS_FILTER_NONE                   0U  // deliver everything (default)
+#define MICROOS_FILTER_ABOVE                  1U  // field > Arg
+#define MICROOS_FILTER_BELOW                  2U  // field < Arg
+#define MICROOS_FILTER_DELTA                  3U  // |field - last delivered field| >= Arg, the first sample always passes
+#define MICROOS_FILTER_MASK                   4U  // (field & Arg) == Match, integer fields only
+
+/** Field types */
+#define MICROOS_FILTER_I32                    0U
+#define MICROOS_FILTER_U32                    1U
+#define MICROOS_FILTER_F32                    2U
+
+typedef union
+{
+    int32_t i32;
+    uint32_t u32;
+    float f32;
+} MicroOS_FilterValue_t;
+
+/**
+ * @brief Predicate on one 32-bit field of the published data, checked before the callback
+ */
+typedef struct
+{
+    uint8_t Kind;               // MICROOS_FILTER_NONE ... MICROOS_FILTER_MASK
+    uint8_t Type;               // MICROOS_FILTER_I32, _U32 or _F32
+    uint16_t Offset;            // byte offset of the field, e.g. offsetof(Imu_t, temp)
+    MicroOS_FilterValue_t Arg;  // threshold, band or mask
+    MicroOS_FilterValue_t Match; // expected bits for MICROOS_FILTER_MASK
+} MicroOS_SubscriberFilter_t;
+#endif
+
+/**
+ * @brief Subscriber handle: index into the shared subscriber pool
+ */
+typedef uint8_t MicroOS_SubscriberHandle_t;
+
+#define MICROOS_SUBSCRIBER_NONE               0xFFU   // end of a subscriber list
+
 typedef struct
 {
     char *name;
     bool IsUsed;
     bool IsRunning;
     MicroOS_SubscriberFunction_t callback;
+    uint8_t Topic;              // topic id the subscriber is linked to
+    uint8_t Id;                 // sub_id, unique within the topic
+    MicroOS_SubscriberHandle_t Prev; // topic list
+    MicroOS_SubscriberHandle_t Next; // topic list, or free list when unused
+#if MICROOS_TOPIC_PRIORITY_ENABLE
+    uint8_t Priority;           // 0 = highest, called first
+#endif
+#if MICROOS_TOPIC_FILTER_ENABLE
+    MicroOS_SubscriberFilter_t Filter;
+    MicroOS_FilterValue_t Last; // field of the last delivered sample (delta filter)
+    bool HasLast;
+#endif
+#if MICROOS_TOPIC_RATE_ENABLE
+    uint32_t MinInterval;       // ticks between callbacks, 0 for no limit
+    uint32_t LastTick;          // tick of the last callback
+    uint16_t Decimation;        // call back on one of every Decimation samples, 0 or 1 for all
+    uint16_t Skipped;           // samples skipped since the last callback
+    bool DeliverLatest;         // deliver the newest skipped sample once MinInterval has elapsed
+    bool Owed;                  // a skipped sample is still to be delivered
+#endif
+#if MICROOS_TOPIC_RING_ENABLE
+    uint32_t Cursor;            // next ring sequence to deliver
+    uint32_t Overruns;          // samples lost because the publisher lapped this subscriber
+#endif
 } MicroOS_Subscriber_t; // 订阅者
  
 typedef struct
@@ -170,17 +537,65 @@ typedef struct
     bool IsUsed;
     bool IsRunning;
     volatile bool IsPending;
+    uint8_t Mode;               // MICROOS_TOPIC_xxx
  
     char *name;              
+#if MICROOS_TOPIC_HASH_ENABLE
+    uint32_t Hash;              // MicroOS_TopicHash(name)
+#endif
     volatile void *Userdata;
-    MicroOS_Subscriber_t subscribers[MICROOS_SUBSCRIBER_NUM];
+#if MICROOS_TOPIC_RING_ENABLE
+    MicroOS_TopicRing_t *Ring;  // sample storage in ring and lossless mode
+#endif
+    MicroOS_TopicValue_t *Value; // value storage in retained mode
+#if MICROOS_TOPIC_FILTER_ENABLE
+    uint16_t ChangeSize;        // bytes hashed for on-change suppression, 0 when off
+    bool HasChangeHash;
+    uint32_t ChangeHash;        // FNV-1a of the last value let through
+#endif
+#if MICROOS_TOPIC_RATE_ENABLE
+    uint8_t OwedCount;          // subscribers owed the newest skipped sample
+#endif
+#if MICROOS_TOPIC_PATTERN_ENABLE
+    uint32_t PatternMap;        // wildcard subscriptions matching the name, pattern i -> MICROOS_BIT(i)
+#if MICROOS_TOPIC_RING_ENABLE
+    uint32_t PatternCursor;     // next ring sequence for the wildcard subscribers
+#endif
+#endif
+    MicroOS_SubscriberHandle_t Head; // subscribers in priority, then subscription order
+    MicroOS_SubscriberHandle_t Tail;
+    uint8_t SubscriberCount;
+    uint8_t Budget;             // subscriber callbacks per scheduler pass, 0 for no limit
+    bool Resuming;              // the last pass ran out of budget
+    MicroOS_SubscriberHandle_t Resume; // first subscriber the next pass delivers to
+    void *ResumeData;           // sample being delivered when the budget ran out
 } MicroOS_Topic_t; // 主题
+
+#if MICROOS_TOPIC_PATTERN_ENABLE
+typedef struct
+{
+    char *filter;               // "sensor/+/accel", "sensor/#": '+' matches one level, '#' the remaining levels
+    MicroOS_Subscriber_t subscriber;
+} MicroOS_PatternSubscriber_t; // 通配符订阅者
+#endif
  
 typedef struct
 {
     // O(1) 查找：没有独立 ID，数组下标本身就是 ID
     MicroOS_Topic_t topics[MICROOS_TOPIC_SIZE];
     uint8_t TopicCount;                          
+    // 订阅者从公共池分配, 按主题串成双向链表; 空闲的用 Next 串成空闲链表
+    MicroOS_Subscriber_t subscribers[MICROOS_SUBSCRIBER_POOL_SIZE];
+    MicroOS_SubscriberHandle_t FreeSubscriber;
+#if MICROOS_TOPIC_PATTERN_ENABLE
+    // 匹配在订阅和创建主题时算好, 记在每个主题的 PatternMap 里, 发布时不做字符串匹配
+    MicroOS_PatternSubscriber_t patterns[MICROOS_TOPIC_PATTERN_SIZE];
+#endif
+    uint8_t CurrentTopic;       // topic being dispatched, see MicroOS_CurrentTopic()
+#if MICROOS_TOPIC_HASH_ENABLE
+    // 开放寻址 (线性探测): 存 topic id + 1, 0 为空槽, 起始槽为 Hash & (MICROOS_TOPIC_HASH_SIZE - 1)
+    uint8_t HashTable[MICROOS_TOPIC_HASH_SIZE];
+#endif
 } MicroOS_PubSub_t; // 发布订阅管理对象
 
 #ifdef __cplusplus
@@ -29,8 +29,30 @@ static void MicroOS_OSEvent_Init(void);
 
 static void MicroOS_DispatchAllEvents(void);
 
+static void MicroOS_OSEvent_SetPending(MicroOS_Event_Sub_t *p);
+
 static void MicroOS_OSdelay_StartScheduler(void);
 
+#if MICROOS_EVENTGROUP_ENABLE
+
+static MicroOS_EventGroup_t OSEventGroup = {0}; // 事件组对象
+
+static void MicroOS_EventGroup_Init(void);
+
+static void MicroOS_EventGroup_Unbind(MicroOS_Event_Sub_t *p);
+
+static void MicroOS_EventGroupDispatch(void);
+#endif
+
+#if MICROOS_DEFER_ENABLE
+
+static MicroOS_Defer_t OSDefer = {0}; // 延迟调用对象
+
+static void MicroOS_Defer_Init(void);
+
+static void MicroOS_DeferDispatch(void);
+#endif
+
 #if MICROOS_MESSAGEEVENT_ENABLE
 
 static MicroOS_MessageEvent_t OSMessageEvent = {0};
@@ -40,6 +62,15 @@ static void MicroOS_MessageEvent_Init(void);
 static void MicroOS_MessageEventDispatch(void);
 #endif
 
+#if MICROOS_RPC_ENABLE
+
+static MicroOS_Rpc_t OSRpc = {0}; // 挂起的远程调用
+
+static void MicroOS_Rpc_Init(void);
+
+static void MicroOS_RpcDispatch(void);
+#endif
+
 #if MICROOS_SUBSCRIPTION_ENABLE
 
 static MicroOS_PubSub_t OSPubSub = {0};
@@ -59,6 +90,14 @@ MicroOS_Status_t MicroOS_Init()
     MicroOS_Task_Handle->CurrentTaskId = 0;
     MicroOS_OSdelay_Init();
     MicroOS_OSEvent_Init();
+#if MICROOS_EVENTGROUP_ENABLE
+    MicroOS_EventGroup_Init();
+#endif
+
+#if MICROOS_DEFER_ENABLE
+    MicroOS_Defer_Init();
+#endif
+
 #if MICROOS_SUBSCRIPTION_ENABLE
     MicroOS_PubSub_Init();
 #endif
@@ -66,6 +105,10 @@ MicroOS_Status_t MicroOS_Init()
 #if MICROOS_MESSAGEEVENT_ENABLE
     MicroOS_MessageEvent_Init();
 #endif
+
+#if MICROOS_RPC_ENABLE
+    MicroOS_Rpc_Init();
+#endif
     return MICROOS_OK;
 }
 
@@ -75,14 +118,26 @@ void MicroOS_StartScheduler(void)
     while (1)
     {
 
+#if MICROOS_EVENTGROUP_ENABLE
+        MicroOS_EventGroupDispatch();
+#endif
+
         MicroOS_DispatchAllEvents();
 
+#if MICROOS_DEFER_ENABLE
+        MicroOS_DeferDispatch();
+#endif
+
         MicroOS_OSdelay_StartScheduler();
 
 #if MICROOS_MESSAGEEVENT_ENABLE
         MicroOS_MessageEventDispatch();
 #endif
 
+#if MICROOS_RPC_ENABLE
+        MicroOS_RpcDispatch();
+#endif
+
 #if MICROOS_SUBSCRIPTION_ENABLE
         MicroOS_TopicDispatch();
 #endif
@@ -383,19 +438,40 @@ static void MicroOS_OSEvent_Init(void)
     OSEvent.free_event = &OSEvent.EventPools[0]; // 空闲事件链表
 }
 
-MicroOS_Status_t MicroOS_RegisterEvent(uint8_t id, char *name, MicroOS_EventFunction_t EventFunction, const void *Userdata)
+// 在挂起位图中标记事件, 可在中断中调用
+// 先置事件位再置优先级位, 分发侧按相反顺序取走, 保证不丢位
+static void MicroOS_OSEvent_SetPending(MicroOS_Event_Sub_t *p)
 {
-    MICROOS_CHECK_PTR(EventFunction);
+    uint8_t slot = (uint8_t)(p - OSEvent.EventPools);
+    uint8_t level = p->Priority;
+
+    MICROOS_ATOMIC_FETCH_OR(&OSEvent.PendingMap[level][slot >> 5], MICROOS_BIT(slot));
+    MICROOS_ATOMIC_FETCH_OR(&OSEvent.PendingLevels, MICROOS_BIT(level));
+}
+
+// 注册/更新事件, EventFunction 与 BatchFunction 二选一
+static MicroOS_Status_t MicroOS_OSEvent_Register(uint8_t id, char *name, MicroOS_EventFunction_t EventFunction, MicroOS_BatchEventFunction_t BatchFunction, const void *Userdata, uint8_t Priority)
+{
+    if (Priority >= MICROOS_EVENT_PRIORITY_NUM)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
     MicroOS_Event_Sub_t *p = OSEvent.active_event;
     while (p)
     {
         if (p->id == id)
         {
+#if MICROOS_EVENTGROUP_ENABLE
+            MicroOS_EventGroup_Unbind(p);
+#endif
             p->name = name;
             p->EventFunction = EventFunction;
+            p->BatchFunction = BatchFunction;
+            p->Priority = Priority;
             p->IsRunning = true;
             p->Userdata = (void *)Userdata;
-            p->Triggered = false;
+            p->TriggerCount = 0;
             p->IsUsed = true;
             return MICROOS_OK;
         }
@@ -410,10 +486,13 @@ MicroOS_Status_t MicroOS_RegisterEvent(uint8_t id, char *name, MicroOS_EventFunc
     OSEvent.free_event = OSEvent.free_event->next;  // 将要用的节点从空闲节点中剔除
 
     node->id = id;
+    node->name = name;
     node->EventFunction = EventFunction;
+    node->BatchFunction = BatchFunction;
+    node->Priority = Priority;
     node->Userdata = (void *)Userdata;
     node->IsRunning = true;
-    node->Triggered = false;
+    node->TriggerCount = 0;
     node->IsUsed = true;
 
     node->next = OSEvent.active_event;
@@ -422,6 +501,20 @@ MicroOS_Status_t MicroOS_RegisterEvent(uint8_t id, char *name, MicroOS_EventFunc
     return MICROOS_OK;
 }
 
+MicroOS_Status_t MicroOS_RegisterEvent(uint8_t id, char *name, MicroOS_EventFunction_t EventFunction, const void *Userdata, uint8_t Priority)
+{
+    MICROOS_CHECK_PTR(EventFunction);
+
+    return MicroOS_OSEvent_Register(id, name, EventFunction, NULL, Userdata, Priority);
+}
+
+MicroOS_Status_t MicroOS_RegisterBatchEvent(uint8_t id, char *name, MicroOS_BatchEventFunction_t BatchFunction, const void *Userdata, uint8_t Priority)
+{
+    MICROOS_CHECK_PTR(BatchFunction);
+
+    return MicroOS_OSEvent_Register(id, name, NULL, BatchFunction, Userdata, Priority);
+}
+
 void MicroOS_DeleteEvent(uint8_t id)
 {
     MicroOS_Event_Sub_t **pp = (MicroOS_Event_Sub_t **)&OSEvent.active_event;
@@ -434,6 +527,10 @@ void MicroOS_DeleteEvent(uint8_t id)
             MicroOS_Event_Sub_t *tmp = *pp;
             *pp = tmp->next;
 
+#if MICROOS_EVENTGROUP_ENABLE
+            MicroOS_EventGroup_Unbind(tmp);
+#endif
+
             memset(tmp, 0, sizeof(MicroOS_Event_Sub_t));
 
             tmp->next = OSEvent.free_event;
@@ -455,7 +552,8 @@ MicroOS_Status_t MicroOS_TriggerEvent(uint8_t id)
     {
         if (p->id == id && p->IsUsed && p->IsRunning)
         {
-            p->Triggered = true;
+            MICROOS_ATOMIC_FETCH_ADD(&p->TriggerCount, 1U);
+            MicroOS_OSEvent_SetPending(p);
             return MICROOS_OK;
         }
         p = p->next;
@@ -486,6 +584,11 @@ MicroOS_Status_t MicroOS_ResumeEvent(uint8_t id)
         if (p->id == id)
         {
             p->IsRunning = true;
+            // 挂起期间到达的触发在恢复时补发
+            if (MICROOS_ATOMIC_LOAD(&p->TriggerCount))
+            {
+                MicroOS_OSEvent_SetPending(p);
+            }
             return MICROOS_OK;
         }
         p = p->next;
@@ -493,309 +596,2426 @@ MicroOS_Status_t MicroOS_ResumeEvent(uint8_t id)
     return MICROOS_ERROR;
 }
 
+// 执行一个已取出挂起位的事件, 返回 false 表示该位已过期
+static bool MicroOS_OSEvent_Run(MicroOS_Event_Sub_t *p, uint8_t level)
+{
+    // 已删除、重新注册或改过优先级的事件会留下过期的挂起位, 直接丢弃
+    if (!p->IsUsed || p->Priority != level || !MICROOS_ATOMIC_LOAD(&p->TriggerCount))
+    {
+        return false;
+    }
+
+    // 挂起的事件保留计数, 由 MicroOS_ResumeEvent 重新置位
+    if (!p->IsRunning)
+    {
+        return false;
+    }
+
+    OSEvent.CurrentEventId = p->id;
+
+    if (p->BatchFunction)
+    {
+        // 一次取走全部计数, 回调期间到达的触发留到下一轮
+        uint32_t count = MICROOS_ATOMIC_EXCHANGE(&p->TriggerCount, 0U);
+        p->BatchFunction(p->Userdata, count);
+        return true;
+    }
+
+    // 每次触发执行一次回调; 只处理本轮快照, 避免中断风暴把主循环卡死
+    uint32_t count = MICROOS_ATOMIC_LOAD(&p->TriggerCount);
+    while (count-- && p->IsUsed && p->IsRunning)
+    {
+        MICROOS_ATOMIC_FETCH_SUB(&p->TriggerCount, 1U);
+        p->EventFunction(p->Userdata);
+    }
+
+    return true;
+}
+
+#if MICROOS_EVENT_PRIORITY_RECHECK
 static void MicroOS_DispatchAllEvents(void)
 {
-    MicroOS_Event_Sub_t *p = OSEvent.active_event;
+    uint32_t done[MICROOS_EVENT_MAP_WORDS] = {0};     // 本轮已执行过的事件
+    uint32_t deferred[MICROOS_EVENT_MAP_WORDS] = {0}; // 本轮再次触发, 推迟到下一轮
+    uint32_t levels;
 
-    while (p)
+    // 每执行完一个事件都重新取最高优先级, 回调期间触发的高优先级事件可以插队
+    while ((levels = MICROOS_ATOMIC_LOAD(&OSEvent.PendingLevels)) != 0U)
     {
-        if (p->IsUsed && p->IsRunning && p->Triggered == true)
+        uint8_t level = MICROOS_CLZ(levels);
+        uint8_t w = 0;
+
+        while (w < MICROOS_EVENT_MAP_WORDS && MICROOS_ATOMIC_LOAD(&OSEvent.PendingMap[level][w]) == 0U)
         {
-            OSEvent.CurrentEventId = p->id;
-            p->EventFunction(p->Userdata);
-            p->Triggered = false;
+            w++;
+        }
+
+        if (w == MICROOS_EVENT_MAP_WORDS)
+        {
+            // 该优先级已空: 清位后再检查一次, 防止与触发方竞争丢位
+            MICROOS_ATOMIC_FETCH_AND(&OSEvent.PendingLevels, ~MICROOS_BIT(level));
+
+            for (w = 0; w < MICROOS_EVENT_MAP_WORDS; w++)
+            {
+                if (MICROOS_ATOMIC_LOAD(&OSEvent.PendingMap[level][w]))
+                {
+                    MICROOS_ATOMIC_FETCH_OR(&OSEvent.PendingLevels, MICROOS_BIT(level));
+                    break;
+                }
+            }
+            continue;
+        }
+
+        uint8_t bit = MICROOS_CLZ(MICROOS_ATOMIC_LOAD(&OSEvent.PendingMap[level][w]));
+        MICROOS_ATOMIC_FETCH_AND(&OSEvent.PendingMap[level][w], ~MICROOS_BIT(bit));
+
+        if (done[w] & MICROOS_BIT(bit))
+        {
+            deferred[w] |= MICROOS_BIT(bit);
+            continue;
+        }
+
+        if (MicroOS_OSEvent_Run(&OSEvent.EventPools[(w << 5) + bit], level))
+        {
+            done[w] |= MICROOS_BIT(bit);
+        }
+    }
+
+    for (uint8_t w = 0; w < MICROOS_EVENT_MAP_WORDS; w++)
+    {
+        while (deferred[w])
+        {
+            uint8_t bit = MICROOS_CLZ(deferred[w]);
+            deferred[w] &= ~MICROOS_BIT(bit);
+            MicroOS_OSEvent_SetPending(&OSEvent.EventPools[(w << 5) + bit]);
+        }
+    }
+}
+#else
+static void MicroOS_DispatchAllEvents(void)
+{
+    // 本轮开始时取走优先级位图快照, 按优先级从高到低分发, 回调期间的新触发留到下一轮
+    uint32_t levels = MICROOS_ATOMIC_EXCHANGE(&OSEvent.PendingLevels, 0U);
+
+    while (levels)
+    {
+        uint8_t level = MICROOS_CLZ(levels);
+        levels &= ~MICROOS_BIT(level);
+
+        for (uint8_t w = 0; w < MICROOS_EVENT_MAP_WORDS; w++)
+        {
+            uint32_t pending = MICROOS_ATOMIC_EXCHANGE(&OSEvent.PendingMap[level][w], 0U);
+
+            while (pending)
+            {
+                uint8_t bit = MICROOS_CLZ(pending);
+                pending &= ~MICROOS_BIT(bit);
+
+                MicroOS_OSEvent_Run(&OSEvent.EventPools[(w << 5) + bit], level);
+            }
         }
-        p = p->next;
     }
 }
+#endif
 
-#if MICROOS_MESSAGEEVENT_ENABLE
-static void MicroOS_MessageEvent_Init()
+#if MICROOS_EVENTGROUP_ENABLE
+static void MicroOS_EventGroup_Init(void)
 {
-    OSMessageEvent.CurrentMessageEventId = 0;
-    OSMessageEvent.MaxMessage = MICROOS_MESSAGEEVENT_SIZE;
-    OSMessageEvent.MessageNum = 0;
+    memset(&OSEventGroup, 0, sizeof(MicroOS_EventGroup_t));
 }
 
-MicroOS_Status_t MicroOS_RegisterMessageEvent(uint8_t id, const char *name, MicroOSQueue_EventFunction_t function)
+// 解除事件与事件组的绑定
+static void MicroOS_EventGroup_Unbind(MicroOS_Event_Sub_t *p)
 {
-    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    if (!p->IsGroupWaiter)
     {
-        return MICROOS_ERROR;
+        return;
     }
 
-    if (OSMessageEvent.MessageNum >= MICROOS_MESSAGEEVENT_SIZE)
+    uint8_t slot = (uint8_t)(p - OSEvent.EventPools);
+
+    OSEventGroup.Groups[p->Group].WaiterMap[slot >> 5] &= ~MICROOS_BIT(slot);
+    p->IsGroupWaiter = false;
+}
+
+MicroOS_Status_t MicroOS_CreateEventGroup(uint8_t id, const char *name)
+{
+    if (id >= MICROOS_EVENTGROUP_SIZE)
     {
-        return MICROOS_ERROR;
+        return MICROOS_INVALID_PARAM;
     }
 
-    MICROOS_CHECK_PTR(function);
-
-    if (OSMessageEvent.Event[id].IsUsed)
+    if (OSEventGroup.Groups[id].IsUsed)
     {
         return MICROOS_BUSY;
     }
 
-    OSMessageEvent.MessageNum++;
-    OSMessageEvent.Event[id].MessageEventFunction = function;
-    OSMessageEvent.Event[id].name = (char *)name;
-    OSMessageEvent.Event[id].IsUsed = true;
-    OSMessageEvent.Event[id].IsRunning = true;
-    // OSMessageEvent.Event[id].TriggerCount = 0;
-    memset(&OSMessageEvent.Event[id].Userdata, 0, sizeof(MicroOSQueue_Message_t));
-    MicroOSQueue_Init(&OSMessageEvent.Event[id].queue);
+    memset(&OSEventGroup.Groups[id], 0, sizeof(MicroOS_EventGroup_Sub_t));
+    OSEventGroup.Groups[id].name = (char *)name;
+    OSEventGroup.Groups[id].IsUsed = true;
 
     return MICROOS_OK;
 }
 
-MicroOS_Status_t MicroOS_DeleteMessageEvent(uint8_t id)
+MicroOS_Status_t MicroOS_DeleteEventGroup(uint8_t id)
 {
-    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    if (id >= MICROOS_EVENTGROUP_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    if (!OSEventGroup.Groups[id].IsUsed)
     {
         return MICROOS_ERROR;
     }
 
-    OSMessageEvent.Event[id].IsUsed = false;
-    OSMessageEvent.Event[id].IsRunning = false;
-    OSMessageEvent.Event[id].name = NULL;
-    memset((void *)&OSMessageEvent.Event[id].Userdata, 0, sizeof(MicroOSQueue_Message_t));
-    MicroOSQueue_Reset(&OSMessageEvent.Event[id].queue);
+    // 等待该组的事件随组一起删除
+    for (uint8_t w = 0; w < MICROOS_EVENT_MAP_WORDS; w++)
+    {
+        while (OSEventGroup.Groups[id].WaiterMap[w])
+        {
+            uint8_t bit = MICROOS_CLZ(OSEventGroup.Groups[id].WaiterMap[w]);
+            MicroOS_DeleteEvent(OSEvent.EventPools[(w << 5) + bit].id);
+        }
+    }
+
+    OSEventGroup.Groups[id].IsUsed = false;
+    OSEventGroup.Groups[id].name = NULL;
+    OSEventGroup.Groups[id].Bits = 0;
 
     return MICROOS_OK;
 }
 
-MicroOS_Status_t MicroOS_TriggerMessageEvent(uint8_t id, const void *data, size_t data_len)
+MicroOS_Status_t MicroOS_WaitEventGroup(uint8_t group_id, uint8_t event_id, char *name, uint32_t mask, uint8_t options, MicroOS_EventFunction_t EventFunction, const void *Userdata, uint8_t Priority)
 {
-    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    if (group_id >= MICROOS_EVENTGROUP_SIZE || mask == 0)
     {
-        return MICROOS_ERROR;
+        return MICROOS_INVALID_PARAM;
     }
 
-    if (OSMessageEvent.Event[id].IsUsed && OSMessageEvent.Event[id].IsRunning)
+    if (!OSEventGroup.Groups[group_id].IsUsed)
     {
+        return MICROOS_ERROR;
+    }
 
-        MicroOS_Status_t ret = MicroOSQueue_Push(&OSMessageEvent.Event[id].queue, data, data_len);
+    MICROOS_CHECK_PTR(EventFunction);
+    MIROOS_CHECK_ERR(MicroOS_OSEvent_Register(event_id, name, EventFunction, NULL, Userdata, Priority));
 
-        if (ret != MICROOS_OK)
-        {
-            return ret;
-        }
+    MicroOS_Event_Sub_t *p = OSEvent.active_event;
+    while (p->id != event_id)
+    {
+        p = p->next;
     }
 
+    uint8_t slot = (uint8_t)(p - OSEvent.EventPools);
+
+    p->Group = group_id;
+    p->WaitMask = mask;
+    p->WaitOptions = options;
+    p->IsGroupWaiter = true;
+    OSEventGroup.Groups[group_id].WaiterMap[slot >> 5] |= MICROOS_BIT(slot);
+
+    // 注册时条件可能已经满足, 让下一轮调度评估一次
+    MICROOS_ATOMIC_FETCH_OR(&OSEventGroup.PendingGroups, MICROOS_BIT(group_id));
+
     return MICROOS_OK;
 }
 
-MicroOS_Status_t MicroOS_SuspendMessageEvent(uint8_t id)
+MicroOS_Status_t MicroOS_SetEventGroupBits(uint8_t id, uint32_t bits)
 {
-    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    if (id >= MICROOS_EVENTGROUP_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    if (!OSEventGroup.Groups[id].IsUsed)
     {
         return MICROOS_ERROR;
     }
 
-    OSMessageEvent.Event[id].IsRunning = false;
+    MICROOS_ATOMIC_FETCH_OR(&OSEventGroup.Groups[id].Bits, bits);
+    MICROOS_ATOMIC_FETCH_OR(&OSEventGroup.PendingGroups, MICROOS_BIT(id));
 
     return MICROOS_OK;
 }
 
-MicroOS_Status_t MicroOS_ResumeMessageEvent(uint8_t id)
+MicroOS_Status_t MicroOS_ClearEventGroupBits(uint8_t id, uint32_t bits)
 {
-    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    if (id >= MICROOS_EVENTGROUP_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    if (!OSEventGroup.Groups[id].IsUsed)
     {
         return MICROOS_ERROR;
     }
 
-    OSMessageEvent.Event[id].IsRunning = true;
+    MICROOS_ATOMIC_FETCH_AND(&OSEventGroup.Groups[id].Bits, ~bits);
 
     return MICROOS_OK;
 }
 
-static void MicroOS_MessageEventDispatch(void)
+uint32_t MicroOS_GetEventGroupBits(uint8_t id)
 {
-    for (uint8_t i = 0; i < MICROOS_MESSAGEEVENT_SIZE; i++)
+    if (id >= MICROOS_EVENTGROUP_SIZE)
     {
-        MicroOS_MessageEvent_Sub_t *evt = &OSMessageEvent.Event[i];
+        return 0;
+    }
 
-        if (!(evt->IsUsed && evt->IsRunning))
-        {
-            continue;
-        }
+    return MICROOS_ATOMIC_LOAD(&OSEventGroup.Groups[id].Bits);
+}
 
-        if (!evt->MessageEventFunction)
+// 只评估置位后发生变化的组, 满足条件的等待者按普通事件触发
+static void MicroOS_EventGroupDispatch(void)
+{
+    uint32_t groups = MICROOS_ATOMIC_EXCHANGE(&OSEventGroup.PendingGroups, 0U);
+
+    while (groups)
+    {
+        uint8_t id = MICROOS_CLZ(groups);
+        groups &= ~MICROOS_BIT(id);
+
+        MicroOS_EventGroup_Sub_t *grp = &OSEventGroup.Groups[id];
+
+        if (!grp->IsUsed)
         {
             continue;
         }
 
-        if (MicroOSQueue_IsEmpty(&evt->queue))
+        uint32_t bits = MICROOS_ATOMIC_LOAD(&grp->Bits);
+        uint32_t clear = 0;
+
+        for (uint8_t w = 0; w < MICROOS_EVENT_MAP_WORDS; w++)
         {
-            continue;
+            uint32_t waiters = grp->WaiterMap[w];
+
+            while (waiters)
+            {
+                uint8_t bit = MICROOS_CLZ(waiters);
+                waiters &= ~MICROOS_BIT(bit);
+
+                MicroOS_Event_Sub_t *p = &OSEvent.EventPools[(w << 5) + bit];
+
+                if (!p->IsRunning)
+                {
+                    continue;
+                }
+
+                bool match = (p->WaitOptions & MICROOS_EVENTGROUP_WAIT_ALL) ? ((bits & p->WaitMask) == p->WaitMask)
+                                                                            : ((bits & p->WaitMask) != 0U);
+                if (!match)
+                {
+                    continue;
+                }
+
+                // 所有等待者评估完之后再统一清位, 同一次置位可以同时满足多个等待者;
+                // 只清快照里置着的位, 没置的位和快照之后中断新置的位留给下一轮评估
+                if (p->WaitOptions & MICROOS_EVENTGROUP_AUTO_CLEAR)
+                {
+                    clear |= bits & p->WaitMask;
+                }
+
+                MICROOS_ATOMIC_FETCH_ADD(&p->TriggerCount, 1U);
+                MicroOS_OSEvent_SetPending(p);
+            }
         }
 
-        if (MicroOSQueue_Pop(&evt->queue, evt->Userdata.data, &evt->Userdata.len) == MICROOS_OK)
+        if (clear)
         {
-            OSMessageEvent.CurrentMessageEventId = i;
-            evt->MessageEventFunction(&evt->Userdata);
+            MICROOS_ATOMIC_FETCH_AND(&grp->Bits, ~clear);
         }
     }
 }
 #endif
 
-#if MICROOS_SUBSCRIPTION_ENABLE
-
-static void MicroOS_PubSub_Init(void)
-{
-    memset(&OSPubSub, 0, sizeof(MicroOS_PubSub_t));
-}
- 
-MicroOS_Status_t MicroOS_CreateTopic(uint8_t id, const char *topic)
+#if MICROOS_DEFER_ENABLE
+static void MicroOS_Defer_Init(void)
 {
-    if (id >= MICROOS_TOPIC_SIZE)
-    {
-        return MICROOS_INVALID_PARAM;
-    }
- 
-    if (OSPubSub.topics[id].IsUsed)
-    {
-        return MICROOS_BUSY;
-    }
- 
-    if (OSPubSub.TopicCount >= MICROOS_TOPIC_SIZE)
+    memset(&OSDefer, 0, sizeof(MicroOS_Defer_t));
+
+    for (uint32_t i = 0; i < MICROOS_DEFER_QUEUE_SIZE; i++)
     {
-        return MICROOS_BUSY;
+        OSDefer.ring[i].seq = i;
     }
- 
-    OSPubSub.TopicCount++;
-    OSPubSub.topics[id].IsUsed = true;
-    OSPubSub.topics[id].name = (char *)topic;
-    memset(OSPubSub.topics[id].subscribers, 0, sizeof(OSPubSub.topics[id].subscribers));
-    OSPubSub.topics[id].Userdata = NULL;
-    OSPubSub.topics[id].IsRunning = true;
-    OSPubSub.topics[id].IsPending = false;
- 
-    return MICROOS_OK;
 }
- 
-MicroOS_Status_t MicroOS_DeleteTopic(uint8_t id)
+
+// 多生产者无锁环形队列: CAS 抢占写位置, 槽位序号发布数据, 任意中断优先级都可调用
+MicroOS_Status_t MicroOS_Defer(MicroOS_DeferFunction_t DeferFunction, void *arg)
 {
-    if (id >= MICROOS_TOPIC_SIZE)
-    {
-        return MICROOS_INVALID_PARAM;
-    }
- 
-    if (OSPubSub.topics[id].IsUsed)
+    MICROOS_CHECK_PTR(DeferFunction);
+
+    uint32_t pos = MICROOS_ATOMIC_LOAD(&OSDefer.tail);
+    MicroOS_Defer_Sub_t *slot;
+
+    for (;;)
     {
-        OSPubSub.TopicCount--;
-        OSPubSub.topics[id].IsUsed = false;
-        OSPubSub.topics[id].name = NULL;
-        memset(OSPubSub.topics[id].subscribers, 0, sizeof(OSPubSub.topics[id].subscribers));
-        OSPubSub.topics[id].Userdata = NULL;
-        OSPubSub.topics[id].IsRunning = false;
-        OSPubSub.topics[id].IsPending = false;
+        slot = &OSDefer.ring[pos & (MICROOS_DEFER_QUEUE_SIZE - 1U)];
+        int32_t diff = (int32_t)(MICROOS_ATOMIC_LOAD(&slot->seq) - pos);
+
+        if (diff == 0)
+        {
+            // 槽位空闲, 抢占成功后独占该槽位; 失败时 pos 已被刷新为最新值
+            if (MICROOS_ATOMIC_CAS(&OSDefer.tail, &pos, pos + 1U))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            MICROOS_ATOMIC_FETCH_ADD(&OSDefer.Dropped, 1U);
+            return MICROOS_QUEUE_FULL;
+        }
+        else
+        {
+            pos = MICROOS_ATOMIC_LOAD(&OSDefer.tail);
+        }
     }
- 
+
+    slot->DeferFunction = DeferFunction;
+    slot->arg = arg;
+    MICROOS_ATOMIC_STORE(&slot->seq, pos + 1U);
+
     return MICROOS_OK;
 }
- 
-// 订阅一个主题
-MicroOS_Status_t MicroOS_Subscribe(uint8_t topic_id, uint8_t sub_id, const char *name, MicroOS_SubscriberFunction_t func)
+
+uint32_t MicroOS_DeferDropped(void)
 {
-    if (topic_id >= MICROOS_TOPIC_SIZE || sub_id >= MICROOS_SUBSCRIBER_NUM)
-    {
+    return MICROOS_ATOMIC_LOAD(&OSDefer.Dropped);
+}
+
+static void MicroOS_DeferDispatch(void)
+{
+    // 每轮最多执行 MICROOS_DEFER_BATCH 个, 剩余的留到下一轮, 不阻塞任务
+    for (uint32_t n = 0; n < MICROOS_DEFER_BATCH; n++)
+    {
+        MicroOS_Defer_Sub_t *slot = &OSDefer.ring[OSDefer.head & (MICROOS_DEFER_QUEUE_SIZE - 1U)];
+
+        // 队列为空, 或生产者已抢到槽位但还没写完
+        if (MICROOS_ATOMIC_LOAD(&slot->seq) != OSDefer.head + 1U)
+        {
+            break;
+        }
+
+        MicroOS_DeferFunction_t DeferFunction = slot->DeferFunction;
+        void *arg = slot->arg;
+
+        MICROOS_ATOMIC_STORE(&slot->seq, OSDefer.head + MICROOS_DEFER_QUEUE_SIZE);
+        OSDefer.head++;
+
+        DeferFunction(arg);
+    }
+}
+#endif
+
+#if MICROOS_MESSAGEEVENT_ENABLE
+static void MicroOS_MessageEvent_Init()
+{
+    OSMessageEvent.CurrentMessageEventId = 0;
+    OSMessageEvent.MaxMessage = MICROOS_MESSAGEEVENT_SIZE;
+    OSMessageEvent.MessageNum = 0;
+    OSMessageEvent.Dispatching = false;
+    OSMessageEvent.CurrentDeleted = false;
+}
+
+// 按队列类型转发, 分发和触发逻辑不关心底层是哪种队列
+static MicroOS_Status_t MicroOS_MessageQueue_Push(MicroOS_MessageEvent_Sub_t *evt, const void *data, size_t data_len)
+{
+    switch (evt->QueueType)
+    {
+    case MICROOS_MSGQUEUE_MPSC:
+        return MicroOSQueue_MPSC_Push(evt->queue.mpsc, data, data_len);
+
+    case MICROOS_MSGQUEUE_PRIO:
+        // 不带优先级的触发进入最低一级
+        return MicroOSQueue_Prio_Push(evt->queue.prio, evt->queue.prio->count - 1U, data, data_len);
+
+    default:
+        return MicroOSQueue_Push(evt->queue.spsc, data, data_len);
+    }
+}
+
+static MicroOS_Status_t MicroOS_MessageQueue_Peek(MicroOS_MessageEvent_Sub_t *evt, const MicroOSQueue_Message_t **msg)
+{
+    switch (evt->QueueType)
+    {
+    case MICROOS_MSGQUEUE_MPSC:
+        return MicroOSQueue_MPSC_Peek(evt->queue.mpsc, msg);
+
+    case MICROOS_MSGQUEUE_PRIO:
+        return MicroOSQueue_Prio_Peek(evt->queue.prio, msg);
+
+    default:
+        return MicroOSQueue_Peek(evt->queue.spsc, msg);
+    }
+}
+
+static uint32_t MicroOS_MessageQueue_PeekN(MicroOS_MessageEvent_Sub_t *evt, const MicroOSQueue_Message_t **msgs, uint32_t count)
+{
+    switch (evt->QueueType)
+    {
+    case MICROOS_MSGQUEUE_MPSC:
+        return MicroOSQueue_MPSC_PeekN(evt->queue.mpsc, msgs, count);
+
+    case MICROOS_MSGQUEUE_PRIO:
+        return MicroOSQueue_Prio_PeekN(evt->queue.prio, msgs, count);
+
+    default:
+        return MicroOSQueue_PeekN(evt->queue.spsc, msgs, count);
+    }
+}
+
+static void MicroOS_MessageQueue_ReleaseN(MicroOS_MessageEvent_Sub_t *evt, uint32_t count)
+{
+    switch (evt->QueueType)
+    {
+    case MICROOS_MSGQUEUE_MPSC:
+        MicroOSQueue_MPSC_ReleaseN(evt->queue.mpsc, count);
+        break;
+
+    case MICROOS_MSGQUEUE_PRIO:
+        MicroOSQueue_Prio_ReleaseN(evt->queue.prio, count);
+        break;
+
+    default:
+        MicroOSQueue_ReleaseN(evt->queue.spsc, count);
+        break;
+    }
+}
+
+static void MicroOS_MessageQueue_Release(MicroOS_MessageEvent_Sub_t *evt)
+{
+    switch (evt->QueueType)
+    {
+    case MICROOS_MSGQUEUE_MPSC:
+        MicroOSQueue_MPSC_Release(evt->queue.mpsc);
+        break;
+
+    case MICROOS_MSGQUEUE_PRIO:
+        MicroOSQueue_Prio_Release(evt->queue.prio);
+        break;
+
+    default:
+        MicroOSQueue_Release(evt->queue.spsc);
+        break;
+    }
+}
+
+static void MicroOS_MessageQueue_Reset(MicroOS_MessageEvent_Sub_t *evt)
+{
+    switch (evt->QueueType)
+    {
+    case MICROOS_MSGQUEUE_MPSC:
+        MicroOSQueue_MPSC_Reset(evt->queue.mpsc);
+        break;
+
+    case MICROOS_MSGQUEUE_PRIO:
+        MicroOSQueue_Prio_Reset(evt->queue.prio);
+        break;
+
+    default:
+        MicroOSQueue_Reset(evt->queue.spsc);
+        break;
+    }
+}
+
+static bool MicroOS_MessageQueue_IsEmpty(MicroOS_MessageEvent_Sub_t *evt)
+{
+    switch (evt->QueueType)
+    {
+    case MICROOS_MSGQUEUE_MPSC:
+        return MicroOSQueue_MPSC_IsEmpty(evt->queue.mpsc);
+
+    case MICROOS_MSGQUEUE_PRIO:
+        return MicroOSQueue_Prio_IsEmpty(evt->queue.prio);
+
+    default:
+        return MicroOSQueue_IsEmpty(evt->queue.spsc);
+    }
+}
+
+// 队列满时是否一定把失败报告给触发者; 丢弃或覆盖策略会悄悄丢掉块引用, 块就再也回不到池里
+static bool MicroOS_MessageQueue_Rejects(MicroOS_MessageEvent_Sub_t *evt)
+{
+    switch (evt->QueueType)
+    {
+    case MICROOS_MSGQUEUE_MPSC:
+        return evt->queue.mpsc->policy == MICROOSQUEUE_POLICY_REJECT;
+
+    case MICROOS_MSGQUEUE_PRIO:
+        for (uint8_t i = 0; i < evt->queue.prio->count; i++)
+        {
+            if (evt->queue.prio->levels[i]->policy != MICROOSQUEUE_POLICY_REJECT)
+            {
+                return false;
+            }
+        }
+        return true;
+
+    default:
+        return evt->queue.spsc->policy == MICROOSQUEUE_POLICY_REJECT;
+    }
+}
+
+// 池化的事件: 队列里存的是块指针, 取出真正的消息
+static const MicroOSQueue_Message_t *MicroOS_MessageEvent_Payload(MicroOS_MessageEvent_Sub_t *evt, const MicroOSQueue_Message_t *msg)
+{
+    if (evt->Pool == NULL)
+    {
+        return msg;
+    }
+
+    const MicroOSQueue_Message_t *block;
+
+    memcpy(&block, msg->data, sizeof(block));
+
+    return block;
+}
+
+// 池化的事件: 回调返回后释放队列对块的引用
+static void MicroOS_MessageEvent_Done(MicroOS_MessageEvent_Sub_t *evt, const MicroOSQueue_Message_t *payload)
+{
+    if (evt->Pool != NULL)
+    {
+        MicroOSPool_Release(payload);
+    }
+}
+
+// 清空队列; 池化的事件要先把排队的块引用逐个还回去
+static void MicroOS_MessageEvent_Drain(MicroOS_MessageEvent_Sub_t *evt)
+{
+    const MicroOSQueue_Message_t *msg;
+
+    while (evt->Pool != NULL && MicroOS_MessageQueue_Peek(evt, &msg) == MICROOS_OK)
+    {
+        MicroOS_MessageEvent_Done(evt, MicroOS_MessageEvent_Payload(evt, msg));
+        MicroOS_MessageQueue_Release(evt);
+    }
+
+    MicroOS_MessageQueue_Reset(evt);
+}
+
+static MicroOS_Status_t MicroOS_MessageEvent_Register(uint8_t id, const char *name, MicroOSQueue_EventFunction_t function, uint8_t type, void *queue)
+{
+    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    {
+        return MICROOS_ERROR;
+    }
+
+    if (OSMessageEvent.MessageNum >= MICROOS_MESSAGEEVENT_SIZE)
+    {
+        return MICROOS_ERROR;
+    }
+
+    MICROOS_CHECK_PTR(function);
+    MICROOS_CHECK_PTR(queue);
+
+    if (OSMessageEvent.Event[id].IsUsed)
+    {
+        return MICROOS_BUSY;
+    }
+
+    // 删除它的回调还没返回: 旧队列等分发器清空后才能再用
+    if (OSMessageEvent.CurrentDeleted && OSMessageEvent.CurrentMessageEventId == id && (void *)OSMessageEvent.Deleted.queue.spsc == queue)
+    {
+        return MICROOS_BUSY;
+    }
+
+    MicroOS_MessageEvent_Sub_t *evt = &OSMessageEvent.Event[id];
+
+    OSMessageEvent.MessageNum++;
+    evt->MessageEventFunction = function;
+    evt->name = (char *)name;
+    evt->BatchFunction = NULL;
+    evt->Budget = MICROOS_MESSAGEEVENT_BUDGET;
+    evt->QueueType = type;
+    evt->Pool = NULL;
+
+    switch (type)
+    {
+    case MICROOS_MSGQUEUE_MPSC:
+        evt->queue.mpsc = (MicroOSQueue_MPSC_t *)queue;
+        break;
+
+    case MICROOS_MSGQUEUE_PRIO:
+        evt->queue.prio = (MicroOSQueue_Prio_t *)queue;
+        break;
+
+    default:
+        evt->queue.spsc = (MicroOSQueue_Obj_t *)queue;
+        break;
+    }
+
+    MicroOS_MessageQueue_Reset(evt);
+    evt->IsUsed = true;
+    evt->IsRunning = true;
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_RegisterMessageEvent(uint8_t id, const char *name, MicroOSQueue_EventFunction_t function, MicroOSQueue_Obj_t *queue)
+{
+    return MicroOS_MessageEvent_Register(id, name, function, MICROOS_MSGQUEUE_SPSC, queue);
+}
+
+MicroOS_Status_t MicroOS_RegisterMessageEventMPSC(uint8_t id, const char *name, MicroOSQueue_EventFunction_t function, MicroOSQueue_MPSC_t *queue)
+{
+    return MicroOS_MessageEvent_Register(id, name, function, MICROOS_MSGQUEUE_MPSC, queue);
+}
+
+MicroOS_Status_t MicroOS_RegisterMessageEventPrio(uint8_t id, const char *name, MicroOSQueue_EventFunction_t function, MicroOSQueue_Prio_t *queue)
+{
+    return MicroOS_MessageEvent_Register(id, name, function, MICROOS_MSGQUEUE_PRIO, queue);
+}
+
+MicroOS_Status_t MicroOS_DeleteMessageEvent(uint8_t id)
+{
+    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    {
+        return MICROOS_ERROR;
+    }
+
+    MicroOS_MessageEvent_Sub_t *evt = &OSMessageEvent.Event[id];
+
+    // 回调里删除自己: 回调还在读队列里的消息 (池化事件还持有块), 交给分发器在回调返回后清空旧队列
+    bool self = OSMessageEvent.Dispatching && OSMessageEvent.CurrentMessageEventId == id;
+
+    if (self)
+    {
+        OSMessageEvent.CurrentDeleted = true;
+        OSMessageEvent.Deleted = *evt;
+    }
+
+    evt->IsUsed = false;
+    evt->IsRunning = false;
+    evt->name = NULL;
+
+    if (evt->queue.spsc)
+    {
+        if (!self)
+        {
+            MicroOS_MessageEvent_Drain(evt);
+        }
+
+        evt->queue.spsc = NULL;
+    }
+
+    evt->Pool = NULL;
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_TriggerMessageEvent(uint8_t id, const void *data, size_t data_len)
+{
+    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    {
+        return MICROOS_ERROR;
+    }
+
+    MicroOS_MessageEvent_Sub_t *evt = &OSMessageEvent.Event[id];
+
+    if (evt->IsUsed && evt->IsRunning)
+    {
+        if (evt->Pool != NULL)
+        {
+            // 载荷只拷贝一次到池里的块, 队列只存块指针
+            MicroOSQueue_Message_t *block = MicroOSPool_Alloc(evt->Pool, data_len);
+
+            if (block == NULL)
+            {
+                return MICROOS_ERROR;
+            }
+
+            if (data_len)
+            {
+                memcpy(block->data, data, data_len);
+            }
+
+            MicroOS_Status_t ret = MicroOS_MessageQueue_Push(evt, &block, sizeof(block));
+
+            if (ret != MICROOS_OK)
+            {
+                MicroOSPool_Release(block);
+            }
+
+            return ret;
+        }
+
+        MicroOS_Status_t ret = MicroOS_MessageQueue_Push(evt, data, data_len);
+
+        if (ret != MICROOS_OK)
+        {
+            return ret;
+        }
+    }
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_TriggerMessageEventShared(uint8_t id, const MicroOSQueue_Message_t *msg)
+{
+    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    {
+        return MICROOS_ERROR;
+    }
+
+    MICROOS_CHECK_PTR(msg);
+
+    MicroOS_MessageEvent_Sub_t *evt = &OSMessageEvent.Event[id];
+
+    if (evt->IsUsed && evt->IsRunning)
+    {
+        if (evt->Pool == NULL)
+        {
+            return MICROOS_INVALID_PARAM;
+        }
+
+        // 队列持有自己的一份引用, 入队失败再退回去
+        MicroOSPool_Retain(msg);
+
+        MicroOS_Status_t ret = MicroOS_MessageQueue_Push(evt, &msg, sizeof(msg));
+
+        if (ret != MICROOS_OK)
+        {
+            MicroOSPool_Release(msg);
+        }
+
+        return ret;
+    }
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_TriggerMessageEventPrio(uint8_t id, uint8_t prio, const void *data, size_t data_len)
+{
+    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    {
+        return MICROOS_ERROR;
+    }
+
+    MicroOS_MessageEvent_Sub_t *evt = &OSMessageEvent.Event[id];
+
+    if (evt->IsUsed && evt->IsRunning)
+    {
+        if (evt->QueueType != MICROOS_MSGQUEUE_PRIO)
+        {
+            return MICROOS_INVALID_PARAM;
+        }
+
+        if (evt->Pool != NULL)
+        {
+            // 与 MicroOS_TriggerMessageEvent 相同: 队列只存块指针
+            MicroOSQueue_Message_t *block = MicroOSPool_Alloc(evt->Pool, data_len);
+
+            if (block == NULL)
+            {
+                return MICROOS_ERROR;
+            }
+
+            if (data_len)
+            {
+                memcpy(block->data, data, data_len);
+            }
+
+            MicroOS_Status_t ret = MicroOSQueue_Prio_Push(evt->queue.prio, prio, &block, sizeof(block));
+
+            if (ret != MICROOS_OK)
+            {
+                MicroOSPool_Release(block);
+            }
+
+            return ret;
+        }
+
+        return MicroOSQueue_Prio_Push(evt->queue.prio, prio, data, data_len);
+    }
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_SuspendMessageEvent(uint8_t id)
+{
+    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    {
+        return MICROOS_ERROR;
+    }
+
+    OSMessageEvent.Event[id].IsRunning = false;
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_ResumeMessageEvent(uint8_t id)
+{
+    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    {
+        return MICROOS_ERROR;
+    }
+
+    OSMessageEvent.Event[id].IsRunning = true;
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_SetMessageEventBudget(uint8_t id, uint8_t budget)
+{
+    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    {
+        return MICROOS_ERROR;
+    }
+
+    if (budget == 0)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    OSMessageEvent.Event[id].Budget = budget;
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_SetMessageEventBatchHandler(uint8_t id, MicroOSQueue_BatchFunction_t function)
+{
+    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    {
+        return MICROOS_ERROR;
+    }
+
+    if (!OSMessageEvent.Event[id].IsUsed)
+    {
+        return MICROOS_ERROR;
+    }
+
+    OSMessageEvent.Event[id].BatchFunction = function;
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_SetMessageEventPool(uint8_t id, MicroOSPool_t *pool)
+{
+    if (id >= MICROOS_MESSAGEEVENT_SIZE)
+    {
+        return MICROOS_ERROR;
+    }
+
+    MicroOS_MessageEvent_Sub_t *evt = &OSMessageEvent.Event[id];
+
+    if (!evt->IsUsed)
+    {
+        return MICROOS_ERROR;
+    }
+
+    // 队列里的消息格式会变, 只能在空队列上切换
+    if (!MicroOS_MessageQueue_IsEmpty(evt))
+    {
+        return MICROOS_BUSY;
+    }
+
+    if (pool != NULL && !MicroOS_MessageQueue_Rejects(evt))
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    evt->Pool = pool;
+
+    return MICROOS_OK;
+}
+
+static void MicroOS_MessageEventDispatch(void)
+{
+    for (uint8_t i = 0; i < MICROOS_MESSAGEEVENT_SIZE; i++)
+    {
+        MicroOS_MessageEvent_Sub_t *evt = &OSMessageEvent.Event[i];
+
+        if (!(evt->IsUsed && evt->IsRunning))
+        {
+            continue;
+        }
+
+        if (!evt->MessageEventFunction)
+        {
+            continue;
+        }
+
+        OSMessageEvent.CurrentMessageEventId = i;
+
+        // 每轮最多处理 Budget 条, 突发消息不必每条都等一整轮调度
+        uint32_t budget = evt->Budget;
+
+        while (budget > 0 && evt->IsUsed && evt->IsRunning)
+        {
+            if (evt->BatchFunction)
+            {
+                const MicroOSQueue_Message_t *msgs[MICROOS_MESSAGEEVENT_BATCH_MAX];
+                uint32_t n = MicroOS_MessageQueue_PeekN(evt, msgs, budget < MICROOS_MESSAGEEVENT_BATCH_MAX ? budget : MICROOS_MESSAGEEVENT_BATCH_MAX);
+
+                if (n == 0)
+                {
+                    break;
+                }
+
+                for (uint32_t k = 0; k < n; k++)
+                {
+                    msgs[k] = MicroOS_MessageEvent_Payload(evt, msgs[k]);
+                }
+
+                // 一次回调拿到一批消息指针, 返回后整批释放
+                OSMessageEvent.Dispatching = true;
+                evt->BatchFunction(msgs, n);
+                OSMessageEvent.Dispatching = false;
+
+                // 回调删除 (或删除后重新注册) 了自己: 这批消息属于旧队列, 释放后清空旧队列, 不碰新注册的队列
+                MicroOS_MessageEvent_Sub_t *owner = OSMessageEvent.CurrentDeleted ? &OSMessageEvent.Deleted : evt;
+
+                for (uint32_t k = 0; k < n; k++)
+                {
+                    MicroOS_MessageEvent_Done(owner, msgs[k]);
+                }
+
+                MicroOS_MessageQueue_ReleaseN(owner, n);
+
+                if (OSMessageEvent.CurrentDeleted)
+                {
+                    MicroOS_MessageEvent_Drain(owner);
+                    OSMessageEvent.CurrentDeleted = false;
+                    break;
+                }
+
+                budget -= n;
+            }
+            else
+            {
+                const MicroOSQueue_Message_t *msg;
+
+                // 回调直接拿到队列槽位里的消息, 返回后才释放槽位
+                if (MicroOS_MessageQueue_Peek(evt, &msg) != MICROOS_OK)
+                {
+                    break;
+                }
+
+                msg = MicroOS_MessageEvent_Payload(evt, msg);
+                OSMessageEvent.Dispatching = true;
+                evt->MessageEventFunction(msg);
+                OSMessageEvent.Dispatching = false;
+
+                MicroOS_MessageEvent_Sub_t *owner = OSMessageEvent.CurrentDeleted ? &OSMessageEvent.Deleted : evt;
+
+                MicroOS_MessageEvent_Done(owner, msg);
+                MicroOS_MessageQueue_Release(owner);
+
+                if (OSMessageEvent.CurrentDeleted)
+                {
+                    MicroOS_MessageEvent_Drain(owner);
+                    OSMessageEvent.CurrentDeleted = false;
+                    break;
+                }
+
+                budget--;
+            }
+        }
+    }
+}
+#endif
+
+#if MICROOS_RPC_ENABLE
+// 调用 ID: 低 8 位是槽位下标, 其余位是代数
+#define MICROOS_RPC_SLOT(call_id)   ((call_id) & 0xFFU)
+#define MICROOS_RPC_GEN(call_id)    ((call_id) >> 8)
+#define MICROOS_RPC_STATE(gen, st)  (((gen) << 2) | (st))
+
+static void MicroOS_Rpc_Init(void)
+{
+    memset(&OSRpc, 0, sizeof(OSRpc));
+    OSRpc.FreeMap = 0xFFFFFFFFU << (32U - MICROOS_RPC_PENDING_SIZE);
+}
+
+static void MicroOS_Rpc_Free(uint8_t slot)
+{
+    MICROOS_ATOMIC_STORE(&OSRpc.Calls[slot].State, MICROOS_RPC_FREE);
+    OSRpc.FreeMap |= MICROOS_BIT(slot);
+}
+
+// 超时 (OSdelay 回调, 调度循环里): 和回复者抢同一个 PENDING 状态, 谁的 CAS 成功谁完成这次调用
+static void MicroOS_Rpc_Timeout(void *Userdata)
+{
+    uint32_t call_id = (uint32_t)(uintptr_t)Userdata;
+    uint8_t slot = (uint8_t)MICROOS_RPC_SLOT(call_id);
+    MicroOS_RpcCall_Sub_t *call = &OSRpc.Calls[slot];
+    uint32_t expected = MICROOS_RPC_STATE(MICROOS_RPC_GEN(call_id), MICROOS_RPC_PENDING);
+
+    if (!MICROOS_ATOMIC_CAS(&call->State, &expected, MICROOS_RPC_STATE(MICROOS_RPC_GEN(call_id), MICROOS_RPC_DONE)))
+    {
+        return;
+    }
+
+    // 槽位的 OSdelay 节点要等这个回调返回后才被移除, 回调返回前不能让新调用用这个槽位
+    call->Callback(MICROOS_TIMEOUT, NULL, 0, call->arg);
+    MicroOS_Rpc_Free(slot);
+}
+
+MicroOS_Status_t MicroOS_RpcCall(uint8_t id, const void *data, size_t data_len, MicroOS_RpcCallback_t callback, void *arg, uint32_t Ticks, uint32_t *call_id)
+{
+    MICROOS_CHECK_PTR(callback);
+
+    if (id >= MICROOS_MESSAGEEVENT_SIZE || data_len > MICROOS_RPC_REQUEST_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    if (data_len)
+    {
+        MICROOS_CHECK_PTR(data);
+    }
+
+    if (!(OSMessageEvent.Event[id].IsUsed && OSMessageEvent.Event[id].IsRunning))
+    {
+        return MICROOS_ERROR;
+    }
+
+    if (OSRpc.FreeMap == 0)
+    {
+        return MICROOS_BUSY;
+    }
+
+    uint8_t slot = MICROOS_CLZ(OSRpc.FreeMap);
+    MicroOS_RpcCall_Sub_t *call = &OSRpc.Calls[slot];
+
+    OSRpc.Generation = (OSRpc.Generation + 1U) & 0x00FFFFFFUL;
+
+    if (OSRpc.Generation == 0)
+    {
+        OSRpc.Generation = 1;
+    }
+
+    uint32_t id_out = (OSRpc.Generation << 8) | slot;
+
+    // 超时交给 OSdelay, 每个槽位固定占用一个保留的 OSdelay ID
+    if (Ticks && MicroOS_OSdelay((uint8_t)(MICROOS_RPC_OSDELAY_ID_BASE + slot), MicroOS_Rpc_Timeout, (const void *)(uintptr_t)id_out, Ticks) != MICROOS_OK)
+    {
+        return MICROOS_BUSY;
+    }
+
+    OSRpc.FreeMap &= ~MICROOS_BIT(slot);
+    call->Callback = callback;
+    call->arg = arg;
+    MICROOS_ATOMIC_STORE(&call->State, MICROOS_RPC_STATE(OSRpc.Generation, MICROOS_RPC_PENDING));
+
+    // 请求 = 调用 ID + 载荷, 一次入队
+    uint8_t frame[MICROOS_RPC_HEADER_SIZE + MICROOS_RPC_REQUEST_SIZE];
+
+    memcpy(frame, &id_out, MICROOS_RPC_HEADER_SIZE);
+
+    if (data_len)
+    {
+        memcpy(frame + MICROOS_RPC_HEADER_SIZE, data, data_len);
+    }
+
+    MicroOS_Status_t ret = MicroOS_TriggerMessageEvent(id, frame, MICROOS_RPC_HEADER_SIZE + data_len);
+
+    if (ret != MICROOS_OK)
+    {
+        if (Ticks)
+        {
+            MicroOS_OSdelay_Remove((uint8_t)(MICROOS_RPC_OSDELAY_ID_BASE + slot));
+        }
+
+        MicroOS_Rpc_Free(slot);
+        return ret;
+    }
+
+    if (call_id)
+    {
+        *call_id = id_out;
+    }
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_RpcReply(uint32_t call_id, const void *data, size_t data_len)
+{
+    uint32_t slot = MICROOS_RPC_SLOT(call_id);
+
+    if (slot >= MICROOS_RPC_PENDING_SIZE || data_len > MICROOS_RPC_REPLY_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    if (data_len)
+    {
+        MICROOS_CHECK_PTR(data);
+    }
+
+    MicroOS_RpcCall_Sub_t *call = &OSRpc.Calls[slot];
+    uint32_t expected = MICROOS_RPC_STATE(MICROOS_RPC_GEN(call_id), MICROOS_RPC_PENDING);
+
+    // 代数不符 (迟到的回复) 或已经超时/取消/回复过
+    if (!MICROOS_ATOMIC_CAS(&call->State, &expected, MICROOS_RPC_STATE(MICROOS_RPC_GEN(call_id), MICROOS_RPC_REPLYING)))
+    {
+        return MICROOS_TIMEOUT;
+    }
+
+    if (data_len)
+    {
+        memcpy(call->Reply, data, data_len);
+    }
+
+    call->ReplyLen = data_len;
+
+    MICROOS_ATOMIC_STORE(&call->State, MICROOS_RPC_STATE(MICROOS_RPC_GEN(call_id), MICROOS_RPC_DONE));
+    MICROOS_ATOMIC_FETCH_OR(&OSRpc.DoneMap, MICROOS_BIT(slot));
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_RpcCancel(uint32_t call_id)
+{
+    uint32_t slot = MICROOS_RPC_SLOT(call_id);
+
+    if (slot >= MICROOS_RPC_PENDING_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    uint32_t expected = MICROOS_RPC_STATE(MICROOS_RPC_GEN(call_id), MICROOS_RPC_PENDING);
+
+    if (!MICROOS_ATOMIC_CAS(&OSRpc.Calls[slot].State, &expected, MICROOS_RPC_FREE))
+    {
+        return MICROOS_ERROR;
+    }
+
+    MicroOS_OSdelay_Remove((uint8_t)(MICROOS_RPC_OSDELAY_ID_BASE + slot));
+    MicroOS_Rpc_Free((uint8_t)slot);
+
+    return MICROOS_OK;
+}
+
+uint32_t MicroOS_RpcCallId(const MicroOSQueue_Message_t *msg)
+{
+    uint32_t call_id;
+
+    if (msg == NULL || msg->len < MICROOS_RPC_HEADER_SIZE)
+    {
+        return 0;
+    }
+
+    memcpy(&call_id, msg->data, MICROOS_RPC_HEADER_SIZE);
+
+    return call_id;
+}
+
+const void *MicroOS_RpcPayload(const MicroOSQueue_Message_t *msg, size_t *len)
+{
+    if (msg == NULL || msg->len < MICROOS_RPC_HEADER_SIZE)
+    {
+        if (len)
+        {
+            *len = 0;
+        }
+
+        return NULL;
+    }
+
+    if (len)
+    {
+        *len = msg->len - MICROOS_RPC_HEADER_SIZE;
+    }
+
+    return msg->data + MICROOS_RPC_HEADER_SIZE;
+}
+
+static void MicroOS_RpcDispatch(void)
+{
+    // 一次取走所有已回复的槽位, 按下标顺序完成
+    uint32_t done = MICROOS_ATOMIC_EXCHANGE(&OSRpc.DoneMap, 0U);
+
+    while (done)
+    {
+        uint8_t slot = MICROOS_CLZ(done);
+        MicroOS_RpcCall_Sub_t *call = &OSRpc.Calls[slot];
+
+        done &= ~MICROOS_BIT(slot);
+
+        MicroOS_OSdelay_Remove((uint8_t)(MICROOS_RPC_OSDELAY_ID_BASE + slot));
+
+        // 回复保存在槽位里, 回调返回后才释放槽位
+        call->Callback(MICROOS_OK, call->Reply, call->ReplyLen, call->arg);
+        MicroOS_Rpc_Free(slot);
+    }
+}
+#endif
+
+#if MICROOS_SUBSCRIPTION_ENABLE
+
+static void MicroOS_PubSub_Init(void)
+{
+    memset(&OSPubSub, 0, sizeof(MicroOS_PubSub_t));
+
+    for (uint8_t i = 0; i < MICROOS_SUBSCRIBER_POOL_SIZE; i++)
+    {
+        OSPubSub.subscribers[i].Next = (i + 1U < MICROOS_SUBSCRIBER_POOL_SIZE) ? (uint8_t)(i + 1U) : MICROOS_SUBSCRIBER_NONE;
+    }
+    OSPubSub.FreeSubscriber = 0U;
+}
+
+// 在主题的订阅者链表里按 sub_id 查找, 主题无效或没找到返回 NULL
+static MicroOS_Subscriber_t *MicroOS_Subscriber_Find(uint8_t topic_id, uint8_t sub_id)
+{
+    if (topic_id >= MICROOS_TOPIC_SIZE || !OSPubSub.topics[topic_id].IsUsed)
+    {
+        return NULL;
+    }
+
+    for (uint8_t h = OSPubSub.topics[topic_id].Head; h != MICROOS_SUBSCRIBER_NONE; h = OSPubSub.subscribers[h].Next)
+    {
+        if (OSPubSub.subscribers[h].Id == sub_id)
+        {
+            return &OSPubSub.subscribers[h];
+        }
+    }
+
+    return NULL;
+}
+
+// 挂进 sub->Topic 的链表: 排在同优先级的订阅者之后, 从链表尾往前找, 默认优先级时 O(1)
+static void MicroOS_Subscriber_Link(MicroOS_SubscriberHandle_t handle)
+{
+    MicroOS_Subscriber_t *sub = &OSPubSub.subscribers[handle];
+    MicroOS_Topic_t *topic = &OSPubSub.topics[sub->Topic];
+    MicroOS_SubscriberHandle_t prev = topic->Tail;
+
+#if MICROOS_TOPIC_PRIORITY_ENABLE
+    while (prev != MICROOS_SUBSCRIBER_NONE && OSPubSub.subscribers[prev].Priority > sub->Priority)
+    {
+        prev = OSPubSub.subscribers[prev].Prev;
+    }
+#endif
+
+    sub->Prev = prev;
+    sub->Next = (prev != MICROOS_SUBSCRIBER_NONE) ? OSPubSub.subscribers[prev].Next : topic->Head;
+
+    if (prev != MICROOS_SUBSCRIBER_NONE)
+    {
+        OSPubSub.subscribers[prev].Next = handle;
+    }
+    else
+    {
+        topic->Head = handle;
+    }
+
+    if (sub->Next != MICROOS_SUBSCRIBER_NONE)
+    {
+        OSPubSub.subscribers[sub->Next].Prev = handle;
+    }
+    else
+    {
+        topic->Tail = handle;
+    }
+}
+
+// 从主题链表摘下, O(1)
+static void MicroOS_Subscriber_Unlink(MicroOS_SubscriberHandle_t handle)
+{
+    MicroOS_Subscriber_t *sub = &OSPubSub.subscribers[handle];
+    MicroOS_Topic_t *topic = &OSPubSub.topics[sub->Topic];
+
+    if (sub->Prev != MICROOS_SUBSCRIBER_NONE)
+    {
+        OSPubSub.subscribers[sub->Prev].Next = sub->Next;
+    }
+    else
+    {
+        topic->Head = sub->Next;
+    }
+
+    if (sub->Next != MICROOS_SUBSCRIBER_NONE)
+    {
+        OSPubSub.subscribers[sub->Next].Prev = sub->Prev;
+    }
+    else
+    {
+        topic->Tail = sub->Prev;
+    }
+}
+
+// 摘下并放回空闲链表
+static void MicroOS_Subscriber_Free(MicroOS_SubscriberHandle_t handle)
+{
+    MicroOS_Subscriber_t *sub = &OSPubSub.subscribers[handle];
+    MicroOS_Topic_t *topic = &OSPubSub.topics[sub->Topic];
+
+    // 下一轮要从它接着分发, 改为从它的后继开始
+    if (topic->Resuming && topic->Resume == handle)
+    {
+        topic->Resume = sub->Next;
+    }
+
+    MicroOS_Subscriber_Unlink(handle);
+    topic->SubscriberCount--;
+#if MICROOS_TOPIC_RATE_ENABLE
+    if (sub->Owed)
+    {
+        topic->OwedCount--;
+    }
+#endif
+
+    memset(sub, 0, sizeof(MicroOS_Subscriber_t));
+    sub->Next = OSPubSub.FreeSubscriber;
+    OSPubSub.FreeSubscriber = handle;
+}
+
+// 回调里可能取消订阅 (连带后继), 先记下后继: 自己仍挂在本主题时以当前后继为准, 否则用记下的后继
+static MicroOS_SubscriberHandle_t MicroOS_Subscriber_Next(uint8_t topic_id, MicroOS_SubscriberHandle_t handle, MicroOS_SubscriberHandle_t next)
+{
+    if (OSPubSub.subscribers[handle].IsUsed && OSPubSub.subscribers[handle].Topic == topic_id)
+    {
+        return OSPubSub.subscribers[handle].Next;
+    }
+
+    if (next != MICROOS_SUBSCRIBER_NONE && OSPubSub.subscribers[next].IsUsed && OSPubSub.subscribers[next].Topic == topic_id)
+    {
+        return next;
+    }
+
+    return MICROOS_SUBSCRIBER_NONE;
+}
+
+#if MICROOS_TOPIC_RATE_ENABLE
+// 主题换了数据来源, 欠下的旧值不再补发
+static void MicroOS_Topic_ClearOwed(MicroOS_Topic_t *topic)
+{
+    for (uint8_t h = topic->Head; h != MICROOS_SUBSCRIBER_NONE; h = OSPubSub.subscribers[h].Next)
+    {
+        OSPubSub.subscribers[h].Owed = false;
+    }
+    topic->OwedCount = 0U;
+}
+#endif
+
+#if MICROOS_TOPIC_HASH_ENABLE
+#define MICROOS_TOPIC_HASH_MASK (MICROOS_TOPIC_HASH_SIZE - 1U)
+
+uint32_t MicroOS_TopicHash(const char *name)
+{
+    uint32_t hash = MICROOS_FNV1A_OFFSET;
+
+    while (*name != '\0')
+    {
+        hash = (hash ^ (uint8_t)*name++) * MICROOS_FNV1A_PRIME;
+    }
+
+    return hash;
+}
+
+// 返回哈希表槽位, 没找到返回 MICROOS_TOPIC_HASH_SIZE; 表比主题数大, 一定有空槽终止探测
+static uint32_t MicroOS_TopicHash_Slot(uint32_t hash)
+{
+    uint32_t i = hash & MICROOS_TOPIC_HASH_MASK;
+
+    while (OSPubSub.HashTable[i] != 0U)
+    {
+        if (OSPubSub.topics[OSPubSub.HashTable[i] - 1U].Hash == hash)
+        {
+            return i;
+        }
+        i = (i + 1U) & MICROOS_TOPIC_HASH_MASK;
+    }
+
+    return MICROOS_TOPIC_HASH_SIZE;
+}
+
+static void MicroOS_TopicHash_Insert(uint8_t id)
+{
+    uint32_t i = OSPubSub.topics[id].Hash & MICROOS_TOPIC_HASH_MASK;
+
+    while (OSPubSub.HashTable[i] != 0U)
+    {
+        i = (i + 1U) & MICROOS_TOPIC_HASH_MASK;
+    }
+
+    OSPubSub.HashTable[i] = (uint8_t)(id + 1U);
+}
+
+// 删除时把后面同一探测链上的条目往回挪, 不需要墓碑
+static void MicroOS_TopicHash_Remove(uint8_t id)
+{
+    uint32_t hole = MicroOS_TopicHash_Slot(OSPubSub.topics[id].Hash);
+    uint32_t j = hole;
+
+    if (hole == MICROOS_TOPIC_HASH_SIZE || OSPubSub.HashTable[hole] != id + 1U)
+    {
+        return;
+    }
+
+    OSPubSub.HashTable[hole] = 0U;
+
+    for (;;)
+    {
+        j = (j + 1U) & MICROOS_TOPIC_HASH_MASK;
+        if (OSPubSub.HashTable[j] == 0U)
+        {
+            break;
+        }
+
+        uint32_t home = OSPubSub.topics[OSPubSub.HashTable[j] - 1U].Hash & MICROOS_TOPIC_HASH_MASK;
+        if (((j - home) & MICROOS_TOPIC_HASH_MASK) >= ((j - hole) & MICROOS_TOPIC_HASH_MASK))
+        {
+            OSPubSub.HashTable[hole] = OSPubSub.HashTable[j];
+            OSPubSub.HashTable[j] = 0U;
+            hole = j;
+        }
+    }
+}
+#endif
+
+#if MICROOS_TOPIC_PATTERN_ENABLE
+// 过滤器按 MQTT 规则检查: '+' 和 '#' 必须独占一级, '#' 只能在最后一级
+static bool MicroOS_TopicPattern_Valid(const char *filter)
+{
+    for (const char *p = filter; *p != '\0'; p++)
+    {
+        if (*p != '+' && *p != '#')
+        {
+            continue;
+        }
+
+        if ((p != filter && p[-1] != '/') || (p[1] != '\0' && p[1] != '/'))
+        {
+            return false;
+        }
+
+        if (*p == '#' && p[1] != '\0')
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// 逐级比较, 只在订阅和创建主题时调用
+static bool MicroOS_TopicPattern_Match(const char *filter, const char *topic)
+{
+    for (;;)
+    {
+        if (*filter == '#')
+        {
+            return true;
+        }
+
+        if (*filter == '+')
+        {
+            filter++;
+            while (*topic != '\0' && *topic != '/')
+            {
+                topic++;
+            }
+        }
+        else
+        {
+            while (*filter != '\0' && *filter != '/')
+            {
+                if (*filter++ != *topic++)
+                {
+                    return false;
+                }
+            }
+
+            if (*topic != '\0' && *topic != '/')
+            {
+                return false;
+            }
+        }
+
+        // 两边都停在 '/' 或结尾
+        if (*filter == '\0')
+        {
+            return *topic == '\0';
+        }
+
+        if (*topic == '\0')
+        {
+            // "sensor/#" 也匹配父级 "sensor"
+            return strcmp(filter, "/#") == 0;
+        }
+
+        filter++;
+        topic++;
+    }
+}
+
+static uint32_t MicroOS_TopicPattern_Bind(const char *topic)
+{
+    uint32_t map = 0U;
+
+    for (uint8_t i = 0; i < MICROOS_TOPIC_PATTERN_SIZE; i++)
+    {
+        if (OSPubSub.patterns[i].subscriber.IsUsed && MicroOS_TopicPattern_Match(OSPubSub.patterns[i].filter, topic))
+        {
+            map |= MICROOS_BIT(i);
+        }
+    }
+
+    return map;
+}
+
+static void MicroOS_TopicPattern_Deliver(const MicroOS_Topic_t *topic, void *data)
+{
+    uint32_t map = topic->PatternMap;
+
+    while (map != 0U)
+    {
+        uint8_t k = MICROOS_CLZ(map);
+        MicroOS_Subscriber_t *sub = &OSPubSub.patterns[k].subscriber;
+
+        map &= ~MICROOS_BIT(k);
+        if (sub->IsRunning && sub->callback != NULL)
+        {
+            sub->callback(data);
+        }
+    }
+}
+#endif
+ 
+MicroOS_Status_t MicroOS_CreateTopic(uint8_t id, const char *topic)
+{
+    if (id >= MICROOS_TOPIC_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+ 
+    if (OSPubSub.topics[id].IsUsed)
+    {
+        return MICROOS_BUSY;
+    }
+ 
+    if (OSPubSub.TopicCount >= MICROOS_TOPIC_SIZE)
+    {
+        return MICROOS_BUSY;
+    }
+
+#if MICROOS_TOPIC_HASH_ENABLE
+    // 名字重复或哈希冲突在创建时就拒绝, 按哈希发布时不再比较字符串
+    if (topic != NULL)
+    {
+        uint32_t hash = MicroOS_TopicHash(topic);
+        if (MicroOS_TopicHash_Slot(hash) != MICROOS_TOPIC_HASH_SIZE)
+        {
+            return MICROOS_BUSY;
+        }
+        OSPubSub.topics[id].Hash = hash;
+        MicroOS_TopicHash_Insert(id);
+    }
+#endif
+ 
+    OSPubSub.TopicCount++;
+    OSPubSub.topics[id].IsUsed = true;
+    OSPubSub.topics[id].name = (char *)topic;
+    OSPubSub.topics[id].Head = MICROOS_SUBSCRIBER_NONE;
+    OSPubSub.topics[id].Tail = MICROOS_SUBSCRIBER_NONE;
+    OSPubSub.topics[id].SubscriberCount = 0U;
+    OSPubSub.topics[id].Budget = MICROOS_TOPIC_BUDGET;
+    OSPubSub.topics[id].Resuming = false;
+    OSPubSub.topics[id].Userdata = NULL;
+    OSPubSub.topics[id].Mode = MICROOS_TOPIC_LATEST;
+#if MICROOS_TOPIC_RING_ENABLE
+    OSPubSub.topics[id].Ring = NULL;
+#endif
+    OSPubSub.topics[id].Value = NULL;
+#if MICROOS_TOPIC_FILTER_ENABLE
+    OSPubSub.topics[id].ChangeSize = 0U;
+    OSPubSub.topics[id].HasChangeHash = false;
+#endif
+#if MICROOS_TOPIC_RATE_ENABLE
+    OSPubSub.topics[id].OwedCount = 0U;
+#endif
+#if MICROOS_TOPIC_PATTERN_ENABLE
+    OSPubSub.topics[id].PatternMap = (topic != NULL) ? MicroOS_TopicPattern_Bind(topic) : 0U;
+#endif
+    OSPubSub.topics[id].IsRunning = true;
+    OSPubSub.topics[id].IsPending = false;
+ 
+    return MICROOS_OK;
+}
+ 
+MicroOS_Status_t MicroOS_DeleteTopic(uint8_t id)
+{
+    if (id >= MICROOS_TOPIC_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+ 
+    if (OSPubSub.topics[id].IsUsed)
+    {
+#if MICROOS_TOPIC_HASH_ENABLE
+        if (OSPubSub.topics[id].name != NULL)
+        {
+            MicroOS_TopicHash_Remove(id);
+        }
+        OSPubSub.topics[id].Hash = 0U;
+#endif
+        // 订阅者归还公共池
+        while (OSPubSub.topics[id].Head != MICROOS_SUBSCRIBER_NONE)
+        {
+            MicroOS_Subscriber_Free(OSPubSub.topics[id].Head);
+        }
+        OSPubSub.TopicCount--;
+        OSPubSub.topics[id].IsUsed = false;
+        OSPubSub.topics[id].name = NULL;
+        OSPubSub.topics[id].Resuming = false;
+        OSPubSub.topics[id].Userdata = NULL;
+        OSPubSub.topics[id].Mode = MICROOS_TOPIC_LATEST;
+#if MICROOS_TOPIC_RING_ENABLE
+        OSPubSub.topics[id].Ring = NULL;
+#endif
+        OSPubSub.topics[id].Value = NULL;
+#if MICROOS_TOPIC_FILTER_ENABLE
+        OSPubSub.topics[id].ChangeSize = 0U;
+        OSPubSub.topics[id].HasChangeHash = false;
+#endif
+#if MICROOS_TOPIC_PATTERN_ENABLE
+        OSPubSub.topics[id].PatternMap = 0U;
+#endif
+        OSPubSub.topics[id].IsRunning = false;
+        OSPubSub.topics[id].IsPending = false;
+    }
+ 
+    return MICROOS_OK;
+}
+ 
+// 订阅一个主题
+MicroOS_Status_t MicroOS_Subscribe(uint8_t topic_id, uint8_t sub_id, const char *name, MicroOS_SubscriberFunction_t func)
+{
+    return MicroOS_SubscribeHandle(topic_id, sub_id, name, func, NULL);
+}
+ 
+MicroOS_Status_t MicroOS_SubscribeHandle(uint8_t topic_id, uint8_t sub_id, const char *name, MicroOS_SubscriberFunction_t func, MicroOS_SubscriberHandle_t *handle)
+{
+    if (topic_id >= MICROOS_TOPIC_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+ 
+    if (!OSPubSub.topics[topic_id].IsUsed)
+    {
+        return MICROOS_ERROR;
+    }
+ 
+    // sub_id 重复或公共池用完
+    if (MicroOS_Subscriber_Find(topic_id, sub_id) != NULL || OSPubSub.FreeSubscriber == MICROOS_SUBSCRIBER_NONE)
+    {
+        return MICROOS_BUSY;
+    }
+ 
+    MicroOS_Topic_t *topic = &OSPubSub.topics[topic_id];
+    MicroOS_SubscriberHandle_t h = OSPubSub.FreeSubscriber;
+    MicroOS_Subscriber_t *sub = &OSPubSub.subscribers[h];
+ 
+    OSPubSub.FreeSubscriber = sub->Next;
+    memset(sub, 0, sizeof(MicroOS_Subscriber_t));
+    sub->IsUsed = true;
+    sub->IsRunning = true;
+    sub->name = (char *)name;
+    sub->callback = func;
+    sub->Topic = topic_id;
+    sub->Id = sub_id;
+#if MICROOS_TOPIC_PRIORITY_ENABLE
+    sub->Priority = MICROOS_SUBSCRIBER_PRIORITY_DEFAULT;
+#endif
+#if MICROOS_TOPIC_RING_ENABLE
+    // 新订阅者只接收订阅之后发布的样本
+    if (topic->Ring != NULL)
+    {
+        sub->Cursor = MICROOS_ATOMIC_LOAD(&topic->Ring->head);
+    }
+#endif
+ 
+    // 同优先级按订阅顺序分发
+    MicroOS_Subscriber_Link(h);
+    topic->SubscriberCount++;
+ 
+    if (handle != NULL)
+    {
+        *handle = h;
+    }
+ 
+    return MICROOS_OK;
+}
+
+#if MICROOS_TOPIC_PATTERN_ENABLE
+MicroOS_Status_t MicroOS_SubscribePattern(uint8_t sub_id, const char *filter, const char *name, MicroOS_SubscriberFunction_t func)
+{
+    if (sub_id >= MICROOS_TOPIC_PATTERN_SIZE || filter == NULL || !MicroOS_TopicPattern_Valid(filter))
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    if (OSPubSub.patterns[sub_id].subscriber.IsUsed)
+    {
+        return MICROOS_BUSY;
+    }
+
+    memset(&OSPubSub.patterns[sub_id], 0, sizeof(MicroOS_PatternSubscriber_t));
+    OSPubSub.patterns[sub_id].filter = (char *)filter;
+    OSPubSub.patterns[sub_id].subscriber.IsUsed = true;
+    OSPubSub.patterns[sub_id].subscriber.IsRunning = true;
+    OSPubSub.patterns[sub_id].subscriber.name = (char *)name;
+    OSPubSub.patterns[sub_id].subscriber.callback = func;
+
+    for (uint8_t i = 0; i < MICROOS_TOPIC_SIZE; i++)
+    {
+        if (OSPubSub.topics[i].IsUsed && OSPubSub.topics[i].name != NULL && MicroOS_TopicPattern_Match(filter, OSPubSub.topics[i].name))
+        {
+#if MICROOS_TOPIC_RING_ENABLE
+            // 与普通订阅者一样只接收之后发布的样本
+            if (OSPubSub.topics[i].PatternMap == 0U && OSPubSub.topics[i].Ring != NULL)
+            {
+                OSPubSub.topics[i].PatternCursor = MICROOS_ATOMIC_LOAD(&OSPubSub.topics[i].Ring->head);
+            }
+#endif
+            OSPubSub.topics[i].PatternMap |= MICROOS_BIT(sub_id);
+        }
+    }
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_UnsubscribePattern(uint8_t sub_id)
+{
+    if (sub_id >= MICROOS_TOPIC_PATTERN_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    if (!OSPubSub.patterns[sub_id].subscriber.IsUsed)
+    {
+        return MICROOS_ERROR;
+    }
+
+    for (uint8_t i = 0; i < MICROOS_TOPIC_SIZE; i++)
+    {
+        OSPubSub.topics[i].PatternMap &= ~MICROOS_BIT(sub_id);
+    }
+
+    memset(&OSPubSub.patterns[sub_id], 0, sizeof(MicroOS_PatternSubscriber_t));
+
+    return MICROOS_OK;
+}
+#endif
+
+uint8_t MicroOS_CurrentTopic(void)
+{
+    return OSPubSub.CurrentTopic;
+}
+ 
+MicroOS_Status_t MicroOS_Unsubscribe(uint8_t topic_id, uint8_t sub_id)
+{
+    if (topic_id >= MICROOS_TOPIC_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+ 
+    MicroOS_Subscriber_t *sub = MicroOS_Subscriber_Find(topic_id, sub_id);
+    if (sub == NULL)
+    {
+        return MICROOS_ERROR;
+    }
+ 
+    MicroOS_Subscriber_Free((MicroOS_SubscriberHandle_t)(sub - OSPubSub.subscribers));
+ 
+    return MICROOS_OK;
+}
+ 
+MicroOS_Status_t MicroOS_UnsubscribeHandle(MicroOS_SubscriberHandle_t handle)
+{
+    if (handle >= MICROOS_SUBSCRIBER_POOL_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+ 
+    if (!OSPubSub.subscribers[handle].IsUsed)
+    {
+        return MICROOS_ERROR;
+    }
+ 
+    MicroOS_Subscriber_Free(handle);
+ 
+    return MICROOS_OK;
+}
+ 
+// 按主题模式保存一次发布
+static MicroOS_Status_t MicroOS_Topic_Store(MicroOS_Topic_t *topic, const void *Userdata)
+{
+    if (topic->Mode == MICROOS_TOPIC_RETAINED)
+    {
+        MicroOS_TopicValue_t *value = topic->Value;
+        uint32_t seq = value->seq;
+
+        if (Userdata == NULL)
+        {
+            return MICROOS_INVALID_PARAM;
+        }
+
+        // 顺序锁: 拷贝期间序号为奇数, 读者看到奇数或前后序号不一致就重试; 回绕时跳过 0, 0 表示从未发布
+        MICROOS_ATOMIC_STORE(&value->seq, seq + 1U);
+        MICROOS_ATOMIC_FENCE();
+        memcpy(value->buffer, Userdata, value->size);
+        MICROOS_ATOMIC_STORE(&value->seq, (seq + 2U != 0U) ? seq + 2U : 2U);
+
+        topic->IsPending = true;
+
+        return MICROOS_OK;
+    }
+
+#if MICROOS_TOPIC_RING_ENABLE
+    if (topic->Ring != NULL)
+    {
+        MicroOS_TopicRing_t *ring = topic->Ring;
+        uint32_t seq = ring->head;
+
+        if (Userdata == NULL)
+        {
+            return MICROOS_INVALID_PARAM;
+        }
+
+        // 无损模式: 最慢的订阅者落后一整圈时拒绝发布, 不覆盖它还没读的样本
+        if (topic->Mode == MICROOS_TOPIC_LOSSLESS && seq - MICROOS_ATOMIC_LOAD(&ring->tail) > ring->mask)
+        {
+            return MICROOS_QUEUE_FULL;
+        }
+
+        memcpy(ring->buffer + (seq & ring->mask) * ring->stride, Userdata, ring->item_size);
+        MICROOS_ATOMIC_STORE(&ring->head, seq + 1U);
+
+        return MICROOS_OK;
+    }
+#endif
+
+    topic->IsPending = true;
+    topic->Userdata = (void *)Userdata;
+ 
+    return MICROOS_OK;
+}
+
+#if MICROOS_TOPIC_FILTER_ENABLE
+static uint32_t MicroOS_Fnv1a(const void *data, size_t size)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t hash = MICROOS_FNV1A_OFFSET;
+
+    while (size-- > 0U)
+    {
+        hash = (hash ^ *p++) * MICROOS_FNV1A_PRIME;
+    }
+
+    return hash;
+}
+#endif
+
+MicroOS_Status_t MicroOS_Publish(uint8_t topic_id, const void *Userdata)
+{
+    if (topic_id >= MICROOS_TOPIC_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+ 
+    if (!OSPubSub.topics[topic_id].IsUsed)
+    {
+        return MICROOS_ERROR;
+    }
+ 
+    if (!OSPubSub.topics[topic_id].IsRunning)
+    {
+        return MICROOS_BUSY;
+    }
+
+#if MICROOS_TOPIC_FILTER_ENABLE
+    MicroOS_Topic_t *topic = &OSPubSub.topics[topic_id];
+
+    if (topic->ChangeSize != 0U && Userdata != NULL)
+    {
+        // 值没变就当作已发布, 订阅者一个都不用唤醒; 只有保存成功才更新哈希, 无损模式被拒后重试不会被误判为未变化
+        uint32_t hash = MicroOS_Fnv1a(Userdata, topic->ChangeSize);
+        if (topic->HasChangeHash && hash == topic->ChangeHash)
+        {
+            return MICROOS_OK;
+        }
+
+        MicroOS_Status_t ret = MicroOS_Topic_Store(topic, Userdata);
+        if (ret == MICROOS_OK)
+        {
+            topic->ChangeHash = hash;
+            topic->HasChangeHash = true;
+        }
+        return ret;
+    }
+#endif
+
+    return MicroOS_Topic_Store(&OSPubSub.topics[topic_id], Userdata);
+}
+
+#if MICROOS_TOPIC_FILTER_ENABLE
+// 订阅者过滤条件要读取的数据大小, 普通模式下未知返回 0
+static size_t MicroOS_Topic_ItemSize(const MicroOS_Topic_t *topic)
+{
+    if (topic->Mode == MICROOS_TOPIC_RETAINED)
+    {
+        return topic->Value->size;
+    }
+#if MICROOS_TOPIC_RING_ENABLE
+    if (topic->Ring != NULL)
+    {
+        return topic->Ring->item_size;
+    }
+#endif
+    return 0U;
+}
+
+// 切换模式后样本大小可能变小, 放不下的过滤条件和变化检测直接关掉, 避免越界读取
+static void MicroOS_Topic_FitFilters(MicroOS_Topic_t *topic)
+{
+    size_t item_size = MicroOS_Topic_ItemSize(topic);
+
+    topic->HasChangeHash = false;
+    if (item_size != 0U && topic->ChangeSize > item_size)
+    {
+        topic->ChangeSize = 0U;
+    }
+
+    for (uint8_t h = topic->Head; h != MICROOS_SUBSCRIBER_NONE; h = OSPubSub.subscribers[h].Next)
+    {
+        MicroOS_Subscriber_t *sub = &OSPubSub.subscribers[h];
+
+        sub->HasLast = false;
+        if (item_size != 0U && (size_t)sub->Filter.Offset + sizeof(MicroOS_FilterValue_t) > item_size)
+        {
+            memset(&sub->Filter, 0, sizeof(sub->Filter));
+        }
+    }
+}
+
+MicroOS_Status_t MicroOS_SetTopicOnChange(uint8_t topic_id, size_t size)
+{
+    if (topic_id >= MICROOS_TOPIC_SIZE || size > 0xFFFFU)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    if (!OSPubSub.topics[topic_id].IsUsed)
+    {
+        return MICROOS_ERROR;
+    }
+
+    size_t item_size = MicroOS_Topic_ItemSize(&OSPubSub.topics[topic_id]);
+    if (item_size != 0U && size > item_size)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    OSPubSub.topics[topic_id].ChangeSize = (uint16_t)size;
+    OSPubSub.topics[topic_id].HasChangeHash = false;
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_SetSubscriberFilter(uint8_t topic_id, uint8_t sub_id, const MicroOS_SubscriberFilter_t *filter)
+{
+    if (topic_id >= MICROOS_TOPIC_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    MicroOS_Subscriber_t *sub = MicroOS_Subscriber_Find(topic_id, sub_id);
+    if (sub == NULL)
+    {
+        return MICROOS_ERROR;
+    }
+
+    if (filter == NULL)
+    {
+        memset(&sub->Filter, 0, sizeof(sub->Filter));
+        sub->HasLast = false;
+        return MICROOS_OK;
+    }
+
+    if (filter->Kind > MICROOS_FILTER_MASK || filter->Type > MICROOS_FILTER_F32 ||
+        (filter->Kind == MICROOS_FILTER_MASK && filter->Type == MICROOS_FILTER_F32))
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    size_t item_size = MicroOS_Topic_ItemSize(&OSPubSub.topics[topic_id]);
+    if (item_size != 0U && (size_t)filter->Offset + sizeof(MicroOS_FilterValue_t) > item_size)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    sub->Filter = *filter;
+    sub->HasLast = false;
+
+    return MICROOS_OK;
+}
+
+// 回调之前检查过滤条件, 通过时记下字段值给死区过滤用
+static bool MicroOS_Subscriber_Accept(MicroOS_Subscriber_t *sub, const void *data)
+{
+    const MicroOS_SubscriberFilter_t *f = &sub->Filter;
+    MicroOS_FilterValue_t v;
+    bool pass = true;
+
+    if (f->Kind == MICROOS_FILTER_NONE || data == NULL)
+    {
+        return true;
+    }
+
+    memcpy(&v, (const uint8_t *)data + f->Offset, sizeof(v));
+
+    switch (f->Kind)
+    {
+    case MICROOS_FILTER_ABOVE:
+        pass = (f->Type == MICROOS_FILTER_F32) ? (v.f32 > f->Arg.f32) :
+               (f->Type == MICROOS_FILTER_I32) ? (v.i32 > f->Arg.i32) : (v.u32 > f->Arg.u32);
+        break;
+    case MICROOS_FILTER_BELOW:
+        pass = (f->Type == MICROOS_FILTER_F32) ? (v.f32 < f->Arg.f32) :
+               (f->Type == MICROOS_FILTER_I32) ? (v.i32 < f->Arg.i32) : (v.u32 < f->Arg.u32);
+        break;
+    case MICROOS_FILTER_DELTA:
+        if (sub->HasLast)
+        {
+            if (f->Type == MICROOS_FILTER_F32)
+            {
+                float d = v.f32 - sub->Last.f32;
+                pass = ((d < 0.0f) ? -d : d) >= f->Arg.f32;
+            }
+            else if (f->Type == MICROOS_FILTER_I32)
+            {
+                int64_t d = (int64_t)v.i32 - sub->Last.i32;
+                pass = (uint64_t)((d < 0) ? -d : d) >= f->Arg.u32;
+            }
+            else
+            {
+                pass = ((v.u32 > sub->Last.u32) ? v.u32 - sub->Last.u32 : sub->Last.u32 - v.u32) >= f->Arg.u32;
+            }
+        }
+        break;
+    case MICROOS_FILTER_MASK:
+        pass = (v.u32 & f->Arg.u32) == f->Match.u32;
+        break;
+    default:
+        break;
+    }
+
+    if (pass)
+    {
+        sub->Last = v;
+        sub->HasLast = true;
+    }
+
+    return pass;
+}
+#endif
+
+#if MICROOS_TOPIC_HASH_ENABLE
+MicroOS_Status_t MicroOS_FindTopic(const char *name, uint8_t *id)
+{
+    if (name == NULL || id == NULL)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    uint32_t slot = MicroOS_TopicHash_Slot(MicroOS_TopicHash(name));
+
+    if (slot == MICROOS_TOPIC_HASH_SIZE)
+    {
+        return MICROOS_ERROR;
+    }
+
+    // 只在解析时比较一次字符串, 排除恰好同哈希的未注册名字
+    uint8_t topic_id = (uint8_t)(OSPubSub.HashTable[slot] - 1U);
+    if (strcmp(OSPubSub.topics[topic_id].name, name) != 0)
+    {
+        return MICROOS_ERROR;
+    }
+
+    *id = topic_id;
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_PublishByHash(uint32_t hash, const void *Userdata)
+{
+    uint32_t slot = MicroOS_TopicHash_Slot(hash);
+
+    if (slot == MICROOS_TOPIC_HASH_SIZE)
+    {
+        return MICROOS_ERROR;
+    }
+
+    return MicroOS_Publish((uint8_t)(OSPubSub.HashTable[slot] - 1U), Userdata);
+}
+#endif
+
+MicroOS_Status_t MicroOS_SetTopicMode(uint8_t topic_id, uint8_t mode, MicroOS_TopicRing_t *ring)
+{
+    if (topic_id >= MICROOS_TOPIC_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    if (!OSPubSub.topics[topic_id].IsUsed)
+    {
+        return MICROOS_ERROR;
+    }
+
+    switch (mode)
+    {
+    case MICROOS_TOPIC_LATEST:
+        break;
+#if MICROOS_TOPIC_RING_ENABLE
+    case MICROOS_TOPIC_RING:
+    case MICROOS_TOPIC_LOSSLESS:
+        if (ring == NULL || ring->buffer == NULL || ring->item_size == 0U || (ring->mask & (ring->mask + 1U)) != 0U)
+        {
+            return MICROOS_INVALID_PARAM;
+        }
+        break;
+#endif
+    default:
+        return MICROOS_INVALID_PARAM;
+    }
+
+    OSPubSub.topics[topic_id].Mode = mode;
+    OSPubSub.topics[topic_id].IsPending = false;
+    OSPubSub.topics[topic_id].Resuming = false;
+#if MICROOS_TOPIC_RATE_ENABLE
+    MicroOS_Topic_ClearOwed(&OSPubSub.topics[topic_id]);
+#endif
+    OSPubSub.topics[topic_id].Userdata = NULL;
+    OSPubSub.topics[topic_id].Value = NULL;
+#if MICROOS_TOPIC_RING_ENABLE
+    OSPubSub.topics[topic_id].Ring = (mode == MICROOS_TOPIC_LATEST) ? NULL : ring;
+    if (ring != NULL && mode != MICROOS_TOPIC_LATEST)
+    {
+        ring->head = 0U;
+        ring->tail = 0U;
+    }
+
+    for (uint8_t h = OSPubSub.topics[topic_id].Head; h != MICROOS_SUBSCRIBER_NONE; h = OSPubSub.subscribers[h].Next)
+    {
+        OSPubSub.subscribers[h].Cursor = 0U;
+        OSPubSub.subscribers[h].Overruns = 0U;
+    }
+#if MICROOS_TOPIC_PATTERN_ENABLE
+    OSPubSub.topics[topic_id].PatternCursor = 0U;
+#endif
+#else
+    (void)ring;
+#endif
+#if MICROOS_TOPIC_FILTER_ENABLE
+    MicroOS_Topic_FitFilters(&OSPubSub.topics[topic_id]);
+#endif
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOS_SetTopicRetained(uint8_t topic_id, MicroOS_TopicValue_t *value)
+{
+    if (topic_id >= MICROOS_TOPIC_SIZE || value == NULL || value->buffer == NULL || value->size == 0U)
+    {
         return MICROOS_INVALID_PARAM;
     }
- 
+
     if (!OSPubSub.topics[topic_id].IsUsed)
     {
         return MICROOS_ERROR;
     }
- 
-    if (OSPubSub.topics[topic_id].subscribers[sub_id].IsUsed)
+
+    OSPubSub.topics[topic_id].Mode = MICROOS_TOPIC_RETAINED;
+    OSPubSub.topics[topic_id].IsPending = false;
+    OSPubSub.topics[topic_id].Resuming = false;
+#if MICROOS_TOPIC_RATE_ENABLE
+    MicroOS_Topic_ClearOwed(&OSPubSub.topics[topic_id]);
+#endif
+    OSPubSub.topics[topic_id].Userdata = NULL;
+#if MICROOS_TOPIC_RING_ENABLE
+    OSPubSub.topics[topic_id].Ring = NULL;
+#endif
+    value->seq = 0U;
+    OSPubSub.topics[topic_id].Value = value;
+#if MICROOS_TOPIC_FILTER_ENABLE
+    MicroOS_Topic_FitFilters(&OSPubSub.topics[topic_id]);
+#endif
+
+    return MICROOS_OK;
+}
+
+// 按顺序锁拷贝一份一致的值, 发布者一直在写 (例如读者是更高优先级的中断) 时有限次重试后放弃
+static MicroOS_Status_t MicroOS_TopicValue_Read(MicroOS_TopicValue_t *value, void *data, uint32_t *seq)
+{
+    for (uint32_t i = 0; i < MICROOS_TOPIC_READ_RETRIES; i++)
     {
-        return MICROOS_BUSY;
+        uint32_t begin = MICROOS_ATOMIC_LOAD(&value->seq);
+
+        if (begin & 1U)
+        {
+            continue;
+        }
+
+        memcpy(data, value->buffer, value->size);
+        MICROOS_ATOMIC_FENCE();
+
+        if (MICROOS_ATOMIC_LOAD(&value->seq) == begin)
+        {
+            if (seq != NULL)
+            {
+                *seq = begin >> 1;
+            }
+            return MICROOS_OK;
+        }
     }
- 
-    OSPubSub.topics[topic_id].subscribers[sub_id].IsUsed = true;
-    OSPubSub.topics[topic_id].subscribers[sub_id].IsRunning = true;
-    OSPubSub.topics[topic_id].subscribers[sub_id].name = (char *)name;
-    OSPubSub.topics[topic_id].subscribers[sub_id].callback = func;
- 
-    return MICROOS_OK;
+
+    return MICROOS_BUSY;
 }
- 
-MicroOS_Status_t MicroOS_Unsubscribe(uint8_t topic_id, uint8_t sub_id)
+
+MicroOS_Status_t MicroOS_ReadTopic(uint8_t topic_id, void *data, size_t size, uint32_t *seq)
 {
-    if (topic_id >= MICROOS_TOPIC_SIZE || sub_id >= MICROOS_SUBSCRIBER_NUM)
+    if (topic_id >= MICROOS_TOPIC_SIZE || data == NULL)
     {
         return MICROOS_INVALID_PARAM;
     }
- 
-    if (!OSPubSub.topics[topic_id].IsUsed)
+
+    if (!OSPubSub.topics[topic_id].IsUsed || OSPubSub.topics[topic_id].Mode != MICROOS_TOPIC_RETAINED)
     {
         return MICROOS_ERROR;
     }
- 
-    if (!OSPubSub.topics[topic_id].subscribers[sub_id].IsUsed)
+
+    MicroOS_TopicValue_t *value = OSPubSub.topics[topic_id].Value;
+
+    if (size < value->size)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    if (MICROOS_ATOMIC_LOAD(&value->seq) == 0U)
+    {
+        return MICROOS_QUEUE_EMPTY;
+    }
+
+    return MicroOS_TopicValue_Read(value, data, seq);
+}
+
+#if MICROOS_TOPIC_RATE_ENABLE
+MicroOS_Status_t MicroOS_SetSubscriberRate(uint8_t topic_id, uint8_t sub_id, uint32_t min_interval, uint16_t decimation, bool deliver_latest)
+{
+    if (topic_id >= MICROOS_TOPIC_SIZE)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    MicroOS_Subscriber_t *sub = MicroOS_Subscriber_Find(topic_id, sub_id);
+    if (sub == NULL)
     {
         return MICROOS_ERROR;
     }
- 
-    memset(&OSPubSub.topics[topic_id].subscribers[sub_id], 0, sizeof(MicroOS_Subscriber_t));
- 
+
+    sub->MinInterval = min_interval;
+    sub->Decimation = decimation;
+    sub->DeliverLatest = deliver_latest;
+    sub->Skipped = 0U;
+    // 第一个样本立即送达
+    sub->LastTick = MicroOS_Task_Handle->TickCount - min_interval;
+    if (sub->Owed)
+    {
+        sub->Owed = false;
+        OSPubSub.topics[topic_id].OwedCount--;
+    }
+
     return MICROOS_OK;
 }
- 
-MicroOS_Status_t MicroOS_Publish(uint8_t topic_id, const void *Userdata)
+#endif
+
+#if MICROOS_TOPIC_PRIORITY_ENABLE
+MicroOS_Status_t MicroOS_SetSubscriberPriority(uint8_t topic_id, uint8_t sub_id, uint8_t priority)
 {
     if (topic_id >= MICROOS_TOPIC_SIZE)
     {
         return MICROOS_INVALID_PARAM;
     }
- 
-    if (!OSPubSub.topics[topic_id].IsUsed)
+
+    MicroOS_Subscriber_t *sub = MicroOS_Subscriber_Find(topic_id, sub_id);
+    if (sub == NULL)
     {
         return MICROOS_ERROR;
     }
- 
-    if (!OSPubSub.topics[topic_id].IsRunning)
+
+    // 重新挂链表, 排到新优先级的末尾
+    MicroOS_SubscriberHandle_t h = (MicroOS_SubscriberHandle_t)(sub - OSPubSub.subscribers);
+    MicroOS_Subscriber_Unlink(h);
+    sub->Priority = priority;
+    MicroOS_Subscriber_Link(h);
+
+    return MICROOS_OK;
+}
+#endif
+
+MicroOS_Status_t MicroOS_SetTopicBudget(uint8_t topic_id, uint8_t budget)
+{
+    if (topic_id >= MICROOS_TOPIC_SIZE)
     {
-        return MICROOS_BUSY;
+        return MICROOS_INVALID_PARAM;
     }
- 
-    OSPubSub.topics[topic_id].IsPending = true;
-    OSPubSub.topics[topic_id].Userdata = (void *)Userdata;
- 
+
+    if (!OSPubSub.topics[topic_id].IsUsed)
+    {
+        return MICROOS_ERROR;
+    }
+
+    OSPubSub.topics[topic_id].Budget = budget;
+
     return MICROOS_OK;
 }
+
+#if MICROOS_TOPIC_RING_ENABLE
+uint32_t MicroOS_GetSubscriberOverruns(uint8_t topic_id, uint8_t sub_id)
+{
+    MicroOS_Subscriber_t *sub = MicroOS_Subscriber_Find(topic_id, sub_id);
+
+    return (sub != NULL) ? sub->Overruns : 0U;
+}
+#endif
  
 MicroOS_Status_t MicroOS_SuspendSubscription(uint8_t topic_id, uint8_t sub_id)
 {
-    if (topic_id >= MICROOS_TOPIC_SIZE || sub_id >= MICROOS_SUBSCRIBER_NUM)
+    if (topic_id >= MICROOS_TOPIC_SIZE)
     {
         return MICROOS_INVALID_PARAM;
     }
  
-    if (!OSPubSub.topics[topic_id].IsUsed)
+    MicroOS_Subscriber_t *sub = MicroOS_Subscriber_Find(topic_id, sub_id);
+    if (sub == NULL)
     {
         return MICROOS_ERROR;
     }
  
-    OSPubSub.topics[topic_id].subscribers[sub_id].IsRunning = false;
+    sub->IsRunning = false;
  
     return MICROOS_OK;
 }
  
 MicroOS_Status_t MicroOS_ResumeSubscription(uint8_t topic_id, uint8_t sub_id)
 {
-    if (topic_id >= MICROOS_TOPIC_SIZE || sub_id >= MICROOS_SUBSCRIBER_NUM)
+    if (topic_id >= MICROOS_TOPIC_SIZE)
     {
         return MICROOS_INVALID_PARAM;
     }
  
-    if (!OSPubSub.topics[topic_id].IsUsed)
+    MicroOS_Subscriber_t *sub = MicroOS_Subscriber_Find(topic_id, sub_id);
+    if (sub == NULL)
     {
         return MICROOS_ERROR;
     }
  
-    OSPubSub.topics[topic_id].subscribers[sub_id].IsRunning = true;
+    sub->IsRunning = true;
  
     return MICROOS_OK;
 }
@@ -812,7 +3032,10 @@ MicroOS_Status_t MicroOS_ClearSubscriptions(uint8_t topic_id)
         return MICROOS_ERROR;
     }
  
-    memset(OSPubSub.topics[topic_id].subscribers, 0, sizeof(OSPubSub.topics[topic_id].subscribers));
+    while (OSPubSub.topics[topic_id].Head != MICROOS_SUBSCRIBER_NONE)
+    {
+        MicroOS_Subscriber_Free(OSPubSub.topics[topic_id].Head);
+    }
  
     return MICROOS_OK;
 }
@@ -829,16 +3052,7 @@ uint8_t MicroOS_SubscriberCount(uint8_t topic_id)
         return 0;
     }
  
-    uint8_t count = 0;
-    for (uint8_t i = 0; i < MICROOS_SUBSCRIBER_NUM; i++)
-    {
-        if (OSPubSub.topics[topic_id].subscribers[i].IsUsed)
-        {
-            count++;
-        }
-    }
- 
-    return count;
+    return OSPubSub.topics[topic_id].SubscriberCount;
 }
 
 bool MicroOS_IsTopicSuspended(uint8_t topic_id)
@@ -853,42 +3067,348 @@ bool MicroOS_IsTopicSuspended(uint8_t topic_id)
  
 bool MicroOS_IsSubscriptionSuspended(uint8_t topic_id, uint8_t sub_id)
 {
-    if (topic_id >= MICROOS_TOPIC_SIZE || sub_id >= MICROOS_SUBSCRIBER_NUM)
+    MicroOS_Subscriber_t *sub = MicroOS_Subscriber_Find(topic_id, sub_id);
+
+    return sub != NULL && sub->IsRunning == false;
+}
+
+// 过滤条件和限速都通过后才调用回调; 限速跳过的样本在 DeliverLatest 时记为欠账, 间隔到了再补发最新值; 返回是否调用了回调
+static bool MicroOS_Subscriber_Deliver(MicroOS_Topic_t *topic, MicroOS_Subscriber_t *sub, void *data)
+{
+#if MICROOS_TOPIC_RATE_ENABLE
+    uint32_t now = MicroOS_Task_Handle->TickCount;
+
+    if((sub->Decimation > 1U && sub->Skipped + 1U < sub->Decimation) ||
+       (sub->MinInterval != 0U && now - sub->LastTick < sub->MinInterval))
+    {
+        if(sub->Skipped < UINT16_MAX)
+        {
+            sub->Skipped++;
+        }
+        if(sub->DeliverLatest && sub->MinInterval != 0U && !sub->Owed)
+        {
+            sub->Owed = true;
+            topic->OwedCount++;
+        }
+        return false;
+    }
+#endif
+
+#if MICROOS_TOPIC_FILTER_ENABLE
+    if(!MicroOS_Subscriber_Accept(sub, data))
     {
         return false;
     }
- 
-    return OSPubSub.topics[topic_id].subscribers[sub_id].IsRunning == false;
+#endif
+
+#if MICROOS_TOPIC_RATE_ENABLE
+    sub->Skipped = 0U;
+    sub->LastTick = now;
+    if(sub->Owed)
+    {
+        sub->Owed = false;
+        topic->OwedCount--;
+    }
+#else
+    (void)topic;
+#endif
+
+    sub->callback(data);
+    return true;
+}
+
+#if MICROOS_TOPIC_RATE_ENABLE
+// 补发欠下的最新值, 只看时间间隔不看抽取计数; data 为 NULL 表示最新值已不可用
+static void MicroOS_Subscriber_DeliverOwed(MicroOS_Topic_t *topic, MicroOS_Subscriber_t *sub, void *data)
+{
+    uint32_t now = MicroOS_Task_Handle->TickCount;
+
+    if(!sub->Owed || now - sub->LastTick < sub->MinInterval)
+    {
+        return;
+    }
+
+    sub->Owed = false;
+    topic->OwedCount--;
+
+    if(data == NULL || !sub->IsUsed || !sub->IsRunning || sub->callback == NULL)
+    {
+        return;
+    }
+
+#if MICROOS_TOPIC_FILTER_ENABLE
+    if(!MicroOS_Subscriber_Accept(sub, data))
+    {
+        return;
+    }
+#endif
+
+    sub->Skipped = 0U;
+    sub->LastTick = now;
+    sub->callback(data);
+}
+#endif
+
+#if MICROOS_TOPIC_RING_ENABLE
+// 仍能安全读取的样本数: 无损模式整圈都受 tail 保护; 普通模式下发布者随时会改写 head 所指的槽
+static inline uint32_t MicroOS_TopicRing_Valid(const MicroOS_Topic_t *topic)
+{
+    return (topic->Mode == MICROOS_TOPIC_LOSSLESS) ? topic->Ring->mask + 1U : topic->Ring->mask;
+}
+
+// 取 seq 号样本交给回调; 普通模式先拷到快照槽, 拷贝期间被发布者追上就作废返回 NULL (seqlock 方式)
+static void *MicroOS_TopicRing_Read(MicroOS_Topic_t *topic, uint32_t seq)
+{
+    MicroOS_TopicRing_t *ring = topic->Ring;
+    uint8_t *slot = ring->buffer + (seq & ring->mask) * ring->stride;
+
+    if(topic->Mode == MICROOS_TOPIC_LOSSLESS)
+    {
+        return slot;
+    }
+
+    uint8_t *snapshot = ring->buffer + (ring->mask + 1U) * ring->stride;
+    memcpy(snapshot, slot, ring->item_size);
+    MICROOS_ATOMIC_FENCE();
+
+    if(MICROOS_ATOMIC_LOAD(&ring->head) - seq > ring->mask)
+    {
+        return NULL;
+    }
+
+    return snapshot;
+}
+
+static void MicroOS_TopicRing_Dispatch(MicroOS_Topic_t *topic)
+{
+    MicroOS_TopicRing_t *ring = topic->Ring;
+    uint32_t depth = MicroOS_TopicRing_Valid(topic);
+    uint32_t head = MICROOS_ATOMIC_LOAD(&ring->head);
+    uint32_t tail = head;
+    uint8_t topic_id = (uint8_t)(topic - OSPubSub.topics);
+    uint32_t calls = 0U;
+    // 上一轮预算用完时从停下的订阅者接着分发
+    MicroOS_SubscriberHandle_t h = topic->Resuming ? topic->Resume : topic->Head;
+
+    for(MicroOS_SubscriberHandle_t next; h != MICROOS_SUBSCRIBER_NONE; h = MicroOS_Subscriber_Next(topic_id, h, next))
+    {
+        MicroOS_Subscriber_t *sub = &OSPubSub.subscribers[h];
+        next = sub->Next;
+
+        if(topic->Budget != 0U && calls >= topic->Budget)
+        {
+            break;
+        }
+
+        if(!sub->IsRunning || sub->callback == NULL)
+        {
+            continue;
+        }
+
+        // 回调里可能取消或挂起自己, 每个样本前重新检查
+        while(sub->IsUsed && sub->Topic == topic_id && sub->IsRunning && (int32_t)(head - sub->Cursor) > 0)
+        {
+            if(topic->Budget != 0U && calls >= topic->Budget)
+            {
+                break;
+            }
+
+            // 被发布者套圈: 跳到仍然有效的最旧样本, 丢失的数量记到自己头上
+            uint32_t lag = MICROOS_ATOMIC_LOAD(&ring->head) - sub->Cursor;
+            if(lag > depth)
+            {
+                sub->Overruns += lag - depth;
+                sub->Cursor += lag - depth;
+                continue;
+            }
+
+            // 拷贝期间被覆盖: 作废这份拷贝, 下一次循环按套圈处理
+            void *item = MicroOS_TopicRing_Read(topic, sub->Cursor);
+            if(item == NULL)
+            {
+                continue;
+            }
+            sub->Cursor++;
+            if(MicroOS_Subscriber_Deliver(topic, sub, item))
+            {
+                calls++;
+            }
+        }
+
+#if MICROOS_TOPIC_RATE_ENABLE
+        // 欠账的是游标前一个样本, 已被套圈覆盖就放弃
+        if(sub->IsUsed && sub->Topic == topic_id && sub->Owed)
+        {
+            uint32_t last = sub->Cursor - 1U;
+            MicroOS_Subscriber_DeliverOwed(topic, sub,
+                (MICROOS_ATOMIC_LOAD(&ring->head) - last <= depth) ? MicroOS_TopicRing_Read(topic, last) : NULL);
+        }
+#endif
+
+        // 预算用完时还有积压, 下一轮从它开始
+        if(topic->Budget != 0U && calls >= topic->Budget &&
+           sub->IsUsed && sub->Topic == topic_id && sub->IsRunning && (int32_t)(head - sub->Cursor) > 0)
+        {
+            break;
+        }
+    }
+
+    topic->Resuming = (h != MICROOS_SUBSCRIBER_NONE);
+    topic->Resume = h;
+
+    for(h = topic->Head; h != MICROOS_SUBSCRIBER_NONE; h = OSPubSub.subscribers[h].Next)
+    {
+        MicroOS_Subscriber_t *sub = &OSPubSub.subscribers[h];
+
+        if(!sub->IsRunning || sub->callback == NULL)
+        {
+            // 挂起期间不接收数据, 也不拖住无损模式的发布者
+            sub->Cursor = head;
+        }
+        else if((int32_t)(sub->Cursor - tail) < 0)
+        {
+            tail = sub->Cursor;
+        }
+    }
+
+#if MICROOS_TOPIC_PATTERN_ENABLE
+    // 所有通配符订阅者共用一个游标, 像一个普通订阅者一样推进, 排在链表之后
+    if(topic->PatternMap == 0U)
+    {
+        topic->PatternCursor = head;
+    }
+
+    while(!topic->Resuming && topic->PatternMap != 0U && (int32_t)(head - topic->PatternCursor) > 0)
+    {
+        uint32_t lag = MICROOS_ATOMIC_LOAD(&ring->head) - topic->PatternCursor;
+        if(lag > depth)
+        {
+            topic->PatternCursor += lag - depth;
+            continue;
+        }
+
+        void *item = MicroOS_TopicRing_Read(topic, topic->PatternCursor);
+        if(item == NULL)
+        {
+            continue;
+        }
+
+        MicroOS_TopicPattern_Deliver(topic, item);
+        topic->PatternCursor++;
+    }
+
+    if(topic->PatternMap != 0U && (int32_t)(topic->PatternCursor - tail) < 0)
+    {
+        tail = topic->PatternCursor;
+    }
+#endif
+
+    MICROOS_ATOMIC_STORE(&ring->tail, tail);
 }
+#endif
 
 static void MicroOS_TopicDispatch(void)
 {
     for(unsigned int i = 0; i < MICROOS_TOPIC_SIZE; i++)
     {
-        if(!OSPubSub.topics[i].IsUsed || !OSPubSub.topics[i].IsRunning)
+        MicroOS_Topic_t *topic = &OSPubSub.topics[i];
+
+        if(!topic->IsUsed || !topic->IsRunning)
         {
             continue;
         }
 
-        if(!OSPubSub.topics[i].IsPending)
+        OSPubSub.CurrentTopic = (uint8_t)i;
+
+#if MICROOS_TOPIC_RING_ENABLE
+        if(topic->Mode == MICROOS_TOPIC_RING || topic->Mode == MICROOS_TOPIC_LOSSLESS)
         {
+            MicroOS_TopicRing_Dispatch(topic);
             continue;
         }
+#endif
 
-        for(unsigned int j = 0; j < MICROOS_SUBSCRIBER_NUM; j++)
+        bool resumed = topic->Resuming;
+        MicroOS_SubscriberHandle_t h = topic->Head;
+        void *data;
+
+        if(resumed)
+        {
+            // 上一轮预算用完: 从停下的订阅者接着送同一份数据
+            h = topic->Resume;
+            data = topic->ResumeData;
+        }
+        else if(!topic->IsPending)
         {
-            if(!OSPubSub.topics[i].subscribers[j].IsRunning || !OSPubSub.topics[i].subscribers[j].IsUsed)
+#if MICROOS_TOPIC_RATE_ENABLE
+            // 没有新数据时补发欠下的最新值: 保留模式是上次的快照, 普通模式是上次的指针
+            for(MicroOS_SubscriberHandle_t next; topic->OwedCount != 0U && h != MICROOS_SUBSCRIBER_NONE; h = MicroOS_Subscriber_Next((uint8_t)i, h, next))
             {
-                continue;
+                next = OSPubSub.subscribers[h].Next;
+                MicroOS_Subscriber_DeliverOwed(topic, &OSPubSub.subscribers[h],
+                    (topic->Mode == MICROOS_TOPIC_RETAINED) ? topic->Value->buffer + topic->Value->stride
+                                                            : (void*)topic->Userdata);
+            }
+#endif
+            continue;
+        }
+        else
+        {
+            data = (void*)topic->Userdata;
+
+            if(topic->Mode == MICROOS_TOPIC_RETAINED)
+            {
+                // 先清标志再取快照, 取快照期间的新发布会在下一轮再分发
+                MicroOS_TopicValue_t *value = topic->Value;
+                topic->IsPending = false;
+                data = value->buffer + value->stride;
+                if(MicroOS_TopicValue_Read(value, data, NULL) != MICROOS_OK)
+                {
+                    topic->IsPending = true;
+                    continue;
+                }
             }
+        }
+
+        // 只遍历本主题的订阅者链表, 不再扫描空槽; 每轮最多 Budget 次回调
+        uint32_t calls = 0U;
+        for(MicroOS_SubscriberHandle_t next; h != MICROOS_SUBSCRIBER_NONE; h = MicroOS_Subscriber_Next((uint8_t)i, h, next))
+        {
+            MicroOS_Subscriber_t *sub = &OSPubSub.subscribers[h];
+            next = sub->Next;
+
+            if(topic->Budget != 0U && calls >= topic->Budget)
+            {
+                break;
+            }
+
+            if(sub->IsRunning && sub->callback && MicroOS_Subscriber_Deliver(topic, sub, data))
+            {
+                calls++;
+            }
+        }
 
-            if(OSPubSub.topics[i].subscribers[j].callback)
+        topic->Resuming = (h != MICROOS_SUBSCRIBER_NONE);
+        if(topic->Resuming)
+        {
+            topic->Resume = h;
+            topic->ResumeData = data;
+            // 这份数据已经开始分发, 之后的发布在分发完后从头再来
+            if(topic->Mode != MICROOS_TOPIC_RETAINED)
             {
-                OSPubSub.topics[i].subscribers[j].callback((void*)OSPubSub.topics[i].Userdata);
+                topic->IsPending = false;
             }
+            continue;
         }
 
-        OSPubSub.topics[i].IsPending = false;
+#if MICROOS_TOPIC_PATTERN_ENABLE
+        MicroOS_TopicPattern_Deliver(topic, data);
+#endif
+
+        if(topic->Mode != MICROOS_TOPIC_RETAINED && !resumed)
+        {
+            topic->IsPending = false;
+        }
     }
 }
 #endif
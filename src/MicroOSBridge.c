@@ -0,0 +1,514 @@
+#include "MicroOSBridge.h"
+#include "MicroOS.h"
+#include "string.h"
+
+#if MICROOS_BRIDGE_ENABLE
+
+// 订阅回调只带数据指针, 靠 MicroOS_CurrentTopic() 查这张表找回导出它的桥
+static MicroOSBridge_t *MicroOSBridge_Routes[MICROOS_TOPIC_SIZE];
+
+// CRC-16/CCITT-FALSE (多项式 0x1021, 初值 0xFFFF), 半字节查表, 表只占 32 字节
+static const uint16_t MicroOSBridge_CrcTable[16] = {
+    0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50A5U, 0x60C6U, 0x70E7U,
+    0x8108U, 0x9129U, 0xA14AU, 0xB16BU, 0xC18CU, 0xD1ADU, 0xE1CEU, 0xF1EFU,
+};
+
+static uint16_t MicroOSBridge_Crc(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFFU;
+
+    while (len--)
+    {
+        crc = (uint16_t)((crc << 4) ^ MicroOSBridge_CrcTable[(crc >> 12) ^ (*data >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ MicroOSBridge_CrcTable[(crc >> 12) ^ (*data & 0x0FU)]);
+        data++;
+    }
+
+    return crc;
+}
+
+// 把编码好的帧尽量写出去, 写不完的下次轮询接着写; 全部写出返回 true
+static bool MicroOSBridge_Send(MicroOSBridge_t *bridge)
+{
+    while (bridge->TxSent < bridge->TxLen)
+    {
+        size_t n = bridge->Transport.write(bridge->Transport.ctx, bridge->TxFrame + bridge->TxSent, bridge->TxLen - bridge->TxSent);
+        if (n == 0U)
+        {
+            return false;
+        }
+        bridge->TxSent += (uint16_t)n;
+    }
+
+    bridge->TxLen = 0U;
+    bridge->TxSent = 0U;
+
+    return true;
+}
+
+// 把攒好的记录编成一帧并开始发送; 上一帧还没写完时不动, 返回 false
+static bool MicroOSBridge_Seal(MicroOSBridge_t *bridge)
+{
+    if (!MicroOSBridge_Send(bridge))
+    {
+        return false;
+    }
+
+    if (bridge->BatchLen == 0U)
+    {
+        return true;
+    }
+
+    uint8_t *frame = bridge->TxFrame;
+    uint16_t len = bridge->BatchLen;
+
+    frame[0] = MICROOSBRIDGE_SOF;
+    frame[1] = (uint8_t)len;
+    frame[2] = bridge->Node | (bridge->Starting ? MICROOSBRIDGE_NODE_START : 0U);
+    frame[3] = bridge->Seq++;
+
+    // 一个窗口的帧都带了重启标记, 之后对端已经不可能再把新序号当成重复
+    if (bridge->Seq == MICROOSBRIDGE_WINDOW)
+    {
+        bridge->Starting = false;
+    }
+    memcpy(frame + MICROOSBRIDGE_HEADER_SIZE, bridge->Batch, len);
+
+    uint16_t crc = MicroOSBridge_Crc(frame + 1, MICROOSBRIDGE_HEADER_SIZE - 1U + len);
+    frame[MICROOSBRIDGE_HEADER_SIZE + len] = (uint8_t)crc;
+    frame[MICROOSBRIDGE_HEADER_SIZE + len + 1U] = (uint8_t)(crc >> 8);
+
+    bridge->TxLen = (uint16_t)(MICROOSBRIDGE_HEADER_SIZE + len + MICROOSBRIDGE_CRC_SIZE);
+    bridge->TxSent = 0U;
+    bridge->BatchLen = 0U;
+    bridge->TxFrames++;
+
+    MicroOSBridge_Send(bridge);
+
+    return true;
+}
+
+static MicroOSBridge_Export_t *MicroOSBridge_FindExport(MicroOSBridge_t *bridge, uint8_t topic_id)
+{
+    for (uint8_t i = 0; i < MICROOS_BRIDGE_EXPORT_NUM; i++)
+    {
+        if (bridge->exports[i].IsUsed && bridge->exports[i].Topic == topic_id)
+        {
+            return &bridge->exports[i];
+        }
+    }
+
+    return NULL;
+}
+
+static MicroOSBridge_Import_t *MicroOSBridge_FindImport(MicroOSBridge_t *bridge, uint8_t channel)
+{
+    for (uint8_t i = 0; i < MICROOS_BRIDGE_IMPORT_NUM; i++)
+    {
+        if (bridge->imports[i].IsUsed && bridge->imports[i].Channel == channel)
+        {
+            return &bridge->imports[i];
+        }
+    }
+
+    return NULL;
+}
+
+// 导出主题的订阅回调: 把样本作为一条记录追加到批里
+static void MicroOSBridge_OnSample(void *data)
+{
+    uint8_t topic_id = MicroOS_CurrentTopic();
+    MicroOSBridge_t *bridge = (topic_id < MICROOS_TOPIC_SIZE) ? MicroOSBridge_Routes[topic_id] : NULL;
+
+    if (bridge == NULL || data == NULL)
+    {
+        return;
+    }
+
+    MicroOSBridge_Export_t *exp = MicroOSBridge_FindExport(bridge, topic_id);
+    if (exp == NULL)
+    {
+        return;
+    }
+
+    if (exp->Latest)
+    {
+        // 批里已有本通道的样本就原地覆盖, 只发最新值
+        for (uint16_t i = 0; i < bridge->BatchLen; i += MICROOSBRIDGE_RECORD_HEADER + bridge->Batch[i + 1U])
+        {
+            if (bridge->Batch[i] == exp->Channel)
+            {
+                memcpy(&bridge->Batch[i + MICROOSBRIDGE_RECORD_HEADER], data, exp->Size);
+                bridge->TxCoalesced++;
+                return;
+            }
+        }
+    }
+
+    // 批满了先封帧, 上一帧还在发就只能丢掉这个样本
+    if ((uint16_t)bridge->BatchLen + MICROOSBRIDGE_RECORD_HEADER + exp->Size > MICROOS_BRIDGE_FRAME_MAX && !MicroOSBridge_Seal(bridge))
+    {
+        bridge->TxDropped++;
+        return;
+    }
+
+    if (bridge->BatchLen == 0U)
+    {
+        bridge->BatchTick = MicroOS_GetTick();
+    }
+
+    bridge->Batch[bridge->BatchLen] = exp->Channel;
+    bridge->Batch[bridge->BatchLen + 1U] = exp->Size;
+    memcpy(&bridge->Batch[bridge->BatchLen + MICROOSBRIDGE_RECORD_HEADER], data, exp->Size);
+    bridge->BatchLen += (uint8_t)(MICROOSBRIDGE_RECORD_HEADER + exp->Size);
+    bridge->TxSamples++;
+
+    if (bridge->FlushTicks == 0U)
+    {
+        MicroOSBridge_Seal(bridge);
+    }
+}
+
+// 按节点做 32 帧的滑动窗口去重; 带重启标记或比窗口还旧的序号当作对端重启, 重新开始计
+static bool MicroOSBridge_Accept(MicroOSBridge_t *bridge, uint8_t node, uint8_t seq)
+{
+    MicroOSBridge_Peer_t *peer = NULL;
+    bool start = (node & MICROOSBRIDGE_NODE_START) != 0U;
+
+    node &= MICROOSBRIDGE_NODE_MAX;
+
+    // 共享总线上回环的自己的帧
+    if (node == bridge->Node)
+    {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < MICROOS_BRIDGE_PEER_NUM; i++)
+    {
+        if (bridge->peers[i].IsUsed && bridge->peers[i].Node == node)
+        {
+            peer = &bridge->peers[i];
+            break;
+        }
+
+        if (peer == NULL && !bridge->peers[i].IsUsed)
+        {
+            peer = &bridge->peers[i];
+        }
+    }
+
+    if (peer == NULL)
+    {
+        // 表满了挤掉一个, 被挤掉的节点下一帧重新登记
+        peer = &bridge->peers[node % MICROOS_BRIDGE_PEER_NUM];
+    }
+
+    // 对端重启后序号从 0 重来, 不重置窗口的话最多 32 个新帧会被当成重复丢掉;
+    // 前 32 帧内又重启的, 只能靠带标记的 0 号帧认出来
+    if (!peer->IsUsed || peer->Node != node || (start && (!peer->Starting || (seq == 0U && peer->Seq != 0U))))
+    {
+        peer->IsUsed = true;
+        peer->Node = node;
+        peer->Starting = start;
+        peer->Seq = seq;
+        peer->Window = 1U;
+        return true;
+    }
+
+    peer->Starting = start;
+
+    uint8_t ahead = (uint8_t)(seq - peer->Seq);
+    if (ahead != 0U && ahead < 128U)
+    {
+        peer->Window = (ahead >= MICROOSBRIDGE_WINDOW) ? 1U : ((peer->Window << ahead) | 1U);
+        peer->Seq = seq;
+        return true;
+    }
+
+    uint8_t back = (uint8_t)(peer->Seq - seq);
+    if (back >= MICROOSBRIDGE_WINDOW)
+    {
+        peer->Seq = seq;
+        peer->Window = 1U;
+        return true;
+    }
+
+    if (peer->Window & (1UL << back))
+    {
+        return false;
+    }
+
+    peer->Window |= 1UL << back;
+
+    return true;
+}
+
+// 把一帧里的记录发布到对应的本地主题
+static void MicroOSBridge_Deliver(MicroOSBridge_t *bridge, const uint8_t *records, uint8_t len)
+{
+    uint16_t i = 0;
+
+    while (i + MICROOSBRIDGE_RECORD_HEADER <= len)
+    {
+        uint8_t channel = records[i];
+        uint8_t size = records[i + 1U];
+        const void *data = &records[i + MICROOSBRIDGE_RECORD_HEADER];
+
+        if (i + MICROOSBRIDGE_RECORD_HEADER + size > len)
+        {
+            bridge->RxErrors++;
+            return;
+        }
+
+        MicroOSBridge_Import_t *imp = MicroOSBridge_FindImport(bridge, channel);
+        if (imp == NULL || imp->Size != size)
+        {
+            bridge->RxDropped++;
+        }
+        else
+        {
+            if (imp->Buffer != NULL)
+            {
+                memcpy(imp->Buffer, data, size);
+                data = imp->Buffer;
+            }
+
+            if (MicroOS_Publish(imp->Topic, data) == MICROOS_OK)
+            {
+                bridge->RxSamples++;
+            }
+            else
+            {
+                bridge->RxDropped++;
+            }
+        }
+
+        i += MICROOSBRIDGE_RECORD_HEADER + size;
+    }
+}
+
+// 从接收缓冲区开头去掉 n 个字节
+static void MicroOSBridge_Consume(MicroOSBridge_t *bridge, uint16_t n)
+{
+    memmove(bridge->RxFrame, bridge->RxFrame + n, bridge->RxLen - n);
+    bridge->RxLen -= n;
+}
+
+// 丢掉当前帧头, 从缓冲区里的下一个 0xA5 重新对齐
+static void MicroOSBridge_Resync(MicroOSBridge_t *bridge)
+{
+    uint16_t i = 1U;
+
+    while (i < bridge->RxLen && bridge->RxFrame[i] != MICROOSBRIDGE_SOF)
+    {
+        i++;
+    }
+
+    MicroOSBridge_Consume(bridge, i);
+}
+
+MicroOS_Status_t MicroOSBridge_Init(MicroOSBridge_t *bridge, uint8_t node, const MicroOSBridge_Transport_t *transport, uint32_t flush_ticks)
+{
+    if (bridge == NULL || transport == NULL || transport->write == NULL || transport->read == NULL || node > MICROOSBRIDGE_NODE_MAX)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    for (uint8_t i = 0; i < MICROOS_TOPIC_SIZE; i++)
+    {
+        if (MicroOSBridge_Routes[i] == bridge)
+        {
+            MicroOSBridge_Routes[i] = NULL;
+        }
+    }
+
+    memset(bridge, 0, sizeof(MicroOSBridge_t));
+    bridge->Transport = *transport;
+    bridge->Node = node;
+    bridge->Starting = true;
+    bridge->FlushTicks = flush_ticks;
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOSBridge_Export(MicroOSBridge_t *bridge, uint8_t topic_id, uint8_t channel, size_t size, bool latest)
+{
+    if (bridge == NULL || topic_id >= MICROOS_TOPIC_SIZE || size == 0U || size > MICROOSBRIDGE_SAMPLE_MAX)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    if (MicroOSBridge_Routes[topic_id] != NULL)
+    {
+        return MICROOS_BUSY;
+    }
+
+    // 再导出导入的主题, 样本会在链路上来回转发
+    for (uint8_t i = 0; i < MICROOS_BRIDGE_IMPORT_NUM; i++)
+    {
+        if (bridge->imports[i].IsUsed && bridge->imports[i].Topic == topic_id)
+        {
+            return MICROOS_BUSY;
+        }
+    }
+
+    MicroOSBridge_Export_t *exp = NULL;
+    for (uint8_t i = 0; i < MICROOS_BRIDGE_EXPORT_NUM; i++)
+    {
+        if (bridge->exports[i].IsUsed && bridge->exports[i].Channel == channel)
+        {
+            return MICROOS_BUSY;
+        }
+
+        if (exp == NULL && !bridge->exports[i].IsUsed)
+        {
+            exp = &bridge->exports[i];
+        }
+    }
+
+    if (exp == NULL)
+    {
+        return MICROOS_BUSY;
+    }
+
+    MicroOS_Status_t status = MicroOS_Subscribe(topic_id, MICROOS_BRIDGE_SUB_ID, "bridge", MicroOSBridge_OnSample);
+    if (status != MICROOS_OK)
+    {
+        return status;
+    }
+
+    exp->IsUsed = true;
+    exp->Latest = latest;
+    exp->Topic = topic_id;
+    exp->Channel = channel;
+    exp->Size = (uint8_t)size;
+    MicroOSBridge_Routes[topic_id] = bridge;
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOSBridge_Import(MicroOSBridge_t *bridge, uint8_t channel, uint8_t topic_id, void *buffer, size_t size)
+{
+    if (bridge == NULL || topic_id >= MICROOS_TOPIC_SIZE || size == 0U || size > MICROOSBRIDGE_SAMPLE_MAX)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    if (MicroOSBridge_Routes[topic_id] == bridge)
+    {
+        return MICROOS_BUSY;
+    }
+
+    MicroOSBridge_Import_t *imp = NULL;
+    for (uint8_t i = 0; i < MICROOS_BRIDGE_IMPORT_NUM; i++)
+    {
+        if (bridge->imports[i].IsUsed && bridge->imports[i].Channel == channel)
+        {
+            return MICROOS_BUSY;
+        }
+
+        if (imp == NULL && !bridge->imports[i].IsUsed)
+        {
+            imp = &bridge->imports[i];
+        }
+    }
+
+    if (imp == NULL)
+    {
+        return MICROOS_BUSY;
+    }
+
+    imp->IsUsed = true;
+    imp->Channel = channel;
+    imp->Topic = topic_id;
+    imp->Size = (uint8_t)size;
+    imp->Buffer = buffer;
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOSBridge_Flush(MicroOSBridge_t *bridge)
+{
+    if (bridge == NULL)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    return MicroOSBridge_Seal(bridge) ? MICROOS_OK : MICROOS_BUSY;
+}
+
+MicroOS_Status_t MicroOSBridge_Poll(MicroOSBridge_t *bridge)
+{
+    if (bridge == NULL)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    MicroOSBridge_Send(bridge);
+
+    if (bridge->BatchLen != 0U && MicroOS_GetTick() - bridge->BatchTick >= bridge->FlushTicks)
+    {
+        MicroOSBridge_Seal(bridge);
+    }
+
+    // 每次只向传输层要当前这一帧还缺的字节, 不会读进下一帧
+    for (uint8_t frames = 0; frames < MICROOS_BRIDGE_RX_BUDGET;)
+    {
+        uint16_t need = MICROOSBRIDGE_HEADER_SIZE;
+
+        if (bridge->RxLen >= 2U)
+        {
+            if (bridge->RxFrame[1] > MICROOS_BRIDGE_FRAME_MAX)
+            {
+                bridge->RxErrors++;
+                MicroOSBridge_Resync(bridge);
+                continue;
+            }
+            need = (uint16_t)(MICROOSBRIDGE_HEADER_SIZE + bridge->RxFrame[1] + MICROOSBRIDGE_CRC_SIZE);
+        }
+
+        if (bridge->RxLen < need)
+        {
+            // 帧头之前只读一个字节, 方便逐字节找 0xA5
+            uint16_t want = (bridge->RxLen == 0U) ? 1U : (uint16_t)(need - bridge->RxLen);
+            size_t n = bridge->Transport.read(bridge->Transport.ctx, bridge->RxFrame + bridge->RxLen, want);
+            if (n == 0U)
+            {
+                break;
+            }
+
+            bridge->RxLen += (uint16_t)n;
+            if (bridge->RxFrame[0] != MICROOSBRIDGE_SOF)
+            {
+                MicroOSBridge_Resync(bridge);
+            }
+            continue;
+        }
+
+        uint8_t len = bridge->RxFrame[1];
+        uint16_t crc = (uint16_t)(bridge->RxFrame[MICROOSBRIDGE_HEADER_SIZE + len] | (bridge->RxFrame[MICROOSBRIDGE_HEADER_SIZE + len + 1U] << 8));
+
+        if (crc != MicroOSBridge_Crc(bridge->RxFrame + 1, MICROOSBRIDGE_HEADER_SIZE - 1U + len))
+        {
+            bridge->RxErrors++;
+            MicroOSBridge_Resync(bridge);
+            continue;
+        }
+
+        frames++;
+        if (MicroOSBridge_Accept(bridge, bridge->RxFrame[2], bridge->RxFrame[3]))
+        {
+            bridge->RxFrames++;
+            MicroOSBridge_Deliver(bridge, bridge->RxFrame + MICROOSBRIDGE_HEADER_SIZE, len);
+        }
+        else
+        {
+            bridge->RxDuplicates++;
+        }
+        MicroOSBridge_Consume(bridge, need);
+    }
+
+    return MICROOS_OK;
+}
+
+#endif
@@ -0,0 +1,173 @@
+#include "MicroOSPool.h"
+#include "MicroOS_com.h"
+#include "string.h"
+
+
+// 块内布局: 头部 (所属类别 + 引用计数) 后面紧跟消息, 对外的句柄就是消息本身
+#define MICROOSPOOL_HEADER(msg) ((MicroOSPool_Header_t *)((uint8_t *)(msg) - MICROOSPOOL_HEADER_SIZE))
+#define MICROOSPOOL_BLOCK(cls, index) ((MicroOSPool_Header_t *)((cls)->buffer + (index) * (cls)->stride))
+
+
+// 在位图里抢一个空闲块: 找到清零的位后用 CAS 置位, 失败说明别的上下文先拿走了, 换一位重试
+static MicroOSPool_Header_t *MicroOSPool_Claim(MicroOSPool_Class_t *cls)
+{
+    for (uint32_t w = 0; w < MICROOSPOOL_MAP_WORDS(cls->count); w++)
+    {
+        uint32_t map = MICROOS_ATOMIC_LOAD(&cls->map[w]);
+
+        while (~map)
+        {
+            uint8_t bit = MICROOS_CLZ(~map);
+            uint32_t index = w * 32U + bit;
+
+            // 最后一个字里超出 count 的位永远视为占用
+            if (index >= cls->count)
+            {
+                break;
+            }
+
+            if (MICROOS_ATOMIC_CAS(&cls->map[w], &map, map | MICROOS_BIT(bit)))
+            {
+                return MICROOSPOOL_BLOCK(cls, index);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+MicroOS_Status_t MicroOSPool_InitClass(MicroOSPool_Class_t *cls, void *buffer, uint32_t *map, uint32_t block_size, uint32_t count)
+{
+    MICROOS_CHECK_PTR(cls);
+    MICROOS_CHECK_PTR(buffer);
+    MICROOS_CHECK_PTR(map);
+
+    if (block_size == 0 || count == 0)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    memset(map, 0, MICROOSPOOL_MAP_WORDS(count) * sizeof(uint32_t));
+
+    cls->buffer = (uint8_t *)buffer;
+    cls->map = map;
+    cls->block_size = block_size;
+    cls->stride = MICROOSPOOL_BLOCK_STRIDE(block_size);
+    cls->count = count;
+    cls->Used = 0;
+    cls->Peak = 0;
+    cls->Failed = 0;
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOSPool_Init(MicroOSPool_t *pool, MicroOSPool_Class_t *const *classes, uint8_t count)
+{
+    MICROOS_CHECK_PTR(pool);
+    MICROOS_CHECK_PTR(classes);
+
+    if (count == 0)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        MICROOS_CHECK_PTR(classes[i]);
+
+        // 类别必须按块大小升序, 分配时才能取到最小的合适块
+        if (i > 0 && classes[i]->block_size < classes[i - 1]->block_size)
+        {
+            return MICROOS_INVALID_PARAM;
+        }
+    }
+
+    pool->classes = classes;
+    pool->count = count;
+
+    return MICROOS_OK;
+}
+
+MicroOSQueue_Message_t *MicroOSPool_Alloc(MicroOSPool_t *pool, size_t size)
+{
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+
+    for (uint8_t i = 0; i < pool->count; i++)
+    {
+        MicroOSPool_Class_t *cls = pool->classes[i];
+
+        if (size > cls->block_size)
+        {
+            continue;
+        }
+
+        MicroOSPool_Header_t *blk = MicroOSPool_Claim(cls);
+
+        // 这个类别用完了, 退到更大的类别
+        if (blk == NULL)
+        {
+            MICROOS_ATOMIC_FETCH_ADD(&cls->Failed, 1U);
+            continue;
+        }
+
+        uint32_t used = MICROOS_ATOMIC_FETCH_ADD(&cls->Used, 1U) + 1U;
+        uint32_t peak = MICROOS_ATOMIC_LOAD(&cls->Peak);
+
+        while (used > peak && !MICROOS_ATOMIC_CAS(&cls->Peak, &peak, used))
+        {
+        }
+
+        blk->owner = cls;
+        MICROOS_ATOMIC_STORE(&blk->refs, 1U);
+
+        MicroOSQueue_Message_t *msg = (MicroOSQueue_Message_t *)((uint8_t *)blk + MICROOSPOOL_HEADER_SIZE);
+        msg->len = size;
+
+        return msg;
+    }
+
+    return NULL;
+}
+
+MicroOS_Status_t MicroOSPool_Retain(const MicroOSQueue_Message_t *msg)
+{
+    MICROOS_CHECK_PTR(msg);
+
+    MICROOS_ATOMIC_FETCH_ADD(&MICROOSPOOL_HEADER(msg)->refs, 1U);
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOSPool_Release(const MicroOSQueue_Message_t *msg)
+{
+    MICROOS_CHECK_PTR(msg);
+
+    MicroOSPool_Header_t *blk = MICROOSPOOL_HEADER(msg);
+    MicroOSPool_Class_t *cls = blk->owner;
+
+    // acq_rel: 所有持有者对块的读写都在最后一次释放之前完成
+    if (MICROOS_ATOMIC_FETCH_SUB(&blk->refs, 1U) != 1U)
+    {
+        return MICROOS_OK;
+    }
+
+    uint32_t index = (uint32_t)(((uint8_t *)blk - cls->buffer) / cls->stride);
+
+    MICROOS_ATOMIC_FETCH_SUB(&cls->Used, 1U);
+    MICROOS_ATOMIC_FETCH_AND(&cls->map[index / 32U], ~MICROOS_BIT(index));
+
+    return MICROOS_OK;
+}
+
+uint32_t MicroOSPool_RefCount(const MicroOSQueue_Message_t *msg)
+{
+    if (msg == NULL)
+    {
+        return 0;
+    }
+
+    return MICROOS_ATOMIC_LOAD(&MICROOSPOOL_HEADER(msg)->refs);
+}
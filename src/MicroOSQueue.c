@@ -3,67 +3,393 @@
 #include "string.h"
 
 
-MicroOS_Status_t MicroOSQueue_Init(MicroOSQueue_Obj_t *obj)
+// 回绕标记: 写端尾部放不下整条消息时写入, 读端遇到后跳回缓冲区开头
+#define MICROOSQUEUE_WRAP_MARK ((size_t)-1)
+
+// 读写位置在 [0, 2 * size) 内计数, 区分满和空且容量不必是 2 的幂;
+// 容量是 2 的幂时 mask != 0, 走按位与的快速路径
+#define MICROOSQUEUE_OFFSET(obj, pos) \
+    ((obj)->mask ? ((pos) & (obj)->mask) : ((pos) >= (obj)->size ? (pos) - (obj)->size : (pos)))
+
+// 取 offset 处的消息头
+#define MICROOSQUEUE_AT(obj, offset) ((MicroOSQueue_Message_t *)((obj)->buffer + (offset)))
+
+
+static inline uint32_t MicroOSQueue_Advance(const MicroOSQueue_Obj_t *obj, uint32_t pos, uint32_t n)
 {
-    MICROOS_CHECK_PTR(obj);
+    pos += n;
+
+    if (obj->mask)
+    {
+        return pos & (2U * obj->size - 1U);
+    }
+
+    return (pos >= 2U * obj->size) ? pos - 2U * obj->size : pos;
+}
+
+static inline uint32_t MicroOSQueue_Used(const MicroOSQueue_Obj_t *obj, uint32_t tail, uint32_t head)
+{
+    return (tail >= head) ? tail - head : tail + 2U * obj->size - head;
+}
+
+// 计算在 tail/head 已知的情况下写入 size 字节消息需要跳过的尾部字节数, 放不下返回 false
+static bool MicroOSQueue_Fits(const MicroOSQueue_Obj_t *obj, uint32_t tail, uint32_t head, size_t size, uint32_t *skip)
+{
+    uint32_t need = MICROOSQUEUE_SLOT_SIZE(size);
+    uint32_t offset = MICROOSQUEUE_OFFSET(obj, tail);
+    uint32_t space = obj->size - MicroOSQueue_Used(obj, tail, head);
+
+    *skip = 0;
+
+    // 尾部连续空间不够, 整条消息挪到开头, 尾部剩余部分作为填充
+    if (obj->size - offset < need)
+    {
+        *skip = obj->size - offset;
+    }
+
+    return (space >= *skip + need);
+}
+
+#if MICROOS_QUEUE_STATS_ENABLE
+// 统计计数: 每个字段只由一端写, 另一端只读
+#define MICROOSQUEUE_STAT_ADD(field, n) MICROOS_ATOMIC_STORE(&(field), (field) + (n))
+#else
+#define MICROOSQUEUE_STAT_ADD(field, n) ((void)0)
+#endif
+
+// 覆盖最旧策略下, 读端持有消息期间置位 head 的最高位, 写端不会丢弃被持有的消息;
+// 位置在 [0, 2*size) 内, 所以这种策略的 size 不能超过 MICROOSQUEUE_OVERWRITE_SIZE_MAX
+#define MICROOSQUEUE_HEAD_LOCK 0x80000000UL
+
+// 写端读取 head (acquire), 去掉持有标志
+static inline uint32_t MicroOSQueue_LoadHead(MicroOSQueue_Obj_t *obj)
+{
+    return MICROOS_ATOMIC_LOAD(&obj->head) & ~MICROOSQUEUE_HEAD_LOCK;
+}
+
+// 写端: 丢弃最旧的一条已发布消息 (或回绕填充), head 被读端持有或没有可丢的消息时返回 false
+static bool MicroOSQueue_DropOldest(MicroOSQueue_Obj_t *obj)
+{
+    uint32_t head = MICROOS_ATOMIC_LOAD(&obj->head);
+
+    for (;;)
+    {
+        // 读端正在处理 head 处的消息, 或者已发布的消息已经全部丢完
+        if ((head & MICROOSQUEUE_HEAD_LOCK) || head == obj->tail)
+        {
+            return false;
+        }
+
+        uint32_t offset = MICROOSQUEUE_OFFSET(obj, head);
+        size_t len = MICROOSQUEUE_AT(obj, offset)->len;
+        uint32_t next = MicroOSQueue_Advance(obj, head, (len == MICROOSQUEUE_WRAP_MARK) ? obj->size - offset : MICROOSQUEUE_SLOT_SIZE(len));
+
+        // 和读端抢 head: 读端先持有或先释放都会让 CAS 失败, 重新判断
+        if (MICROOS_ATOMIC_CAS(&obj->head, &head, next))
+        {
+            obj->head_cache = next;
 
-    memset(obj,0,sizeof(MicroOSQueue_Obj_t));
+            if (len != MICROOSQUEUE_WRAP_MARK)
+            {
+                MICROOSQUEUE_STAT_ADD(obj->stats.Overwrites, 1U);
+            }
+
+            return true;
+        }
+    }
+}
+
+// 写端: 在本地写位置 *tail 上为 size 字节的消息腾出连续空间, 必要时写回绕标记
+static MicroOS_Status_t MicroOSQueue_Claim(MicroOSQueue_Obj_t *obj, uint32_t *tail, size_t size)
+{
+    uint32_t skip;
+
+    if (size > obj->msg_size)
+    {
+        return MICROOS_ERROR;
+    }
+
+    // 先用缓存的读位置判断, 空间不够时才去读共享的 head (acquire: 读端对槽位的读取已完成)
+    while (!MicroOSQueue_Fits(obj, *tail, obj->head_cache, size, &skip))
+    {
+        obj->head_cache = MicroOSQueue_LoadHead(obj);
+
+        if (MicroOSQueue_Fits(obj, *tail, obj->head_cache, size, &skip))
+        {
+            break;
+        }
+
+        if (obj->policy != MICROOSQUEUE_POLICY_OVERWRITE_OLDEST || !MicroOSQueue_DropOldest(obj))
+        {
+            return MICROOS_QUEUE_FULL;
+        }
+    }
+
+    // 尾部放不下: 写回绕标记, 读端会跳过它, 消息从缓冲区开头开始
+    if (skip != 0)
+    {
+        MICROOSQUEUE_AT(obj, MICROOSQUEUE_OFFSET(obj, *tail))->len = MICROOSQUEUE_WRAP_MARK;
+        *tail = MicroOSQueue_Advance(obj, *tail, skip);
+    }
 
     return MICROOS_OK;
 }
 
+// 写端: 发布 n 条新消息后更新统计
+static void MicroOSQueue_Published(MicroOSQueue_Obj_t *obj, uint32_t n)
+{
+#if MICROOS_QUEUE_STATS_ENABLE
+    MICROOSQUEUE_STAT_ADD(obj->stats.Pushes, n);
+
+    uint32_t held = obj->stats.Pushes - obj->stats.Overwrites - MICROOS_ATOMIC_LOAD(&obj->stats.Pops);
+
+    if (held > obj->stats.HighWater)
+    {
+        MICROOS_ATOMIC_STORE(&obj->stats.HighWater, held);
+    }
+#else
+    (void)obj;
+    (void)n;
+#endif
+}
+
+// 读端: 开始读取, 返回本地读位置; 覆盖最旧策略下同时持有 head, 防止写端丢弃正在读的消息
+static uint32_t MicroOSQueue_HoldHead(MicroOSQueue_Obj_t *obj)
+{
+    if (obj->policy != MICROOSQUEUE_POLICY_OVERWRITE_OLDEST)
+    {
+        return obj->head;
+    }
+
+    uint32_t head = MICROOS_ATOMIC_LOAD(&obj->head);
+
+    // Peek 之后还没 Release, 已经持有
+    if (!(head & MICROOSQUEUE_HEAD_LOCK))
+    {
+        while (!MICROOS_ATOMIC_CAS(&obj->head, &head, head | MICROOSQUEUE_HEAD_LOCK))
+        {
+        }
+
+        // 写端可能丢弃过消息, head 已越过缓存的 tail, 重新读取
+        obj->tail_cache = MICROOS_ATOMIC_LOAD(&obj->tail);
+    }
+
+    return head & ~MICROOSQUEUE_HEAD_LOCK;
+}
+
+// 读端: 发布新的读位置, hold 为 true 时继续持有 (Peek 之后)
+static void MicroOSQueue_PutHead(MicroOSQueue_Obj_t *obj, uint32_t head, bool hold)
+{
+    if (obj->policy == MICROOSQUEUE_POLICY_OVERWRITE_OLDEST)
+    {
+        MICROOS_ATOMIC_STORE(&obj->head, hold ? (head | MICROOSQUEUE_HEAD_LOCK) : head);
+    }
+    else if (head != obj->head)
+    {
+        // release: 对这批槽位的读取完成之后才把空间还给写端
+        MICROOS_ATOMIC_STORE(&obj->head, head);
+    }
+}
+
+// 读端: 本地读位置 *head 跳过回绕标记, 返回该位置是否有消息
+static bool MicroOSQueue_Next(MicroOSQueue_Obj_t *obj, uint32_t *head)
+{
+    // 先用缓存的写位置判断, 只有看起来为空时才去读共享的 tail
+    if (*head == obj->tail_cache)
+    {
+        obj->tail_cache = MICROOS_ATOMIC_LOAD(&obj->tail);
+
+        if (*head == obj->tail_cache)
+        {
+            return false;
+        }
+    }
+
+    uint32_t offset = MICROOSQUEUE_OFFSET(obj, *head);
+
+    if (MICROOSQUEUE_AT(obj, offset)->len == MICROOSQUEUE_WRAP_MARK)
+    {
+        *head = MicroOSQueue_Advance(obj, *head, obj->size - offset);
+
+        // 回绕标记可能先于消息本身发布, 跳过后重新确认
+        if (*head == obj->tail_cache)
+        {
+            obj->tail_cache = MICROOS_ATOMIC_LOAD(&obj->tail);
+        }
+    }
+
+    return (*head != obj->tail_cache);
+}
+
+MicroOS_Status_t MicroOSQueue_Init(MicroOSQueue_Obj_t *obj, void *buffer, uint32_t size, uint32_t msg_size)
+{
+    MICROOS_CHECK_PTR(obj);
+    MICROOS_CHECK_PTR(buffer);
+
+    // 容量按 size_t 向下对齐, 至少要放得下一条最大长度的消息
+    size -= size % sizeof(size_t);
+
+    if (msg_size == 0 || size < MICROOSQUEUE_STORAGE_SIZE(1U, msg_size))
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    obj->buffer = (uint8_t *)buffer;
+    obj->size = size;
+    obj->mask = MICROOSQUEUE_MASK(size);
+    obj->msg_size = msg_size;
+    obj->policy = MICROOSQUEUE_POLICY_REJECT;
+
+    MicroOSQueue_ResetStats(obj);
+
+    return MicroOSQueue_Reset(obj);
+}
+
 MicroOS_Status_t MicroOSQueue_Reset(MicroOSQueue_Obj_t *obj)
 {
     MICROOS_CHECK_PTR(obj);
 
-    memset(obj,0,sizeof(MicroOSQueue_Obj_t));
+    obj->head = 0;
+    obj->tail = 0;
+    obj->head_cache = 0;
+    obj->tail_cache = 0;
+    obj->reserved = 0;
+    obj->reserving = false;
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOSQueue_SetPolicy(MicroOSQueue_Obj_t *obj, uint8_t policy)
+{
+    MICROOS_CHECK_PTR(obj);
+
+    if (policy > MICROOSQUEUE_POLICY_OVERWRITE_OLDEST)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    // 更大的缓冲区里 head 的最高位是正常位置的一部分, 会被当成持有标志
+    if (policy == MICROOSQUEUE_POLICY_OVERWRITE_OLDEST && obj->size > MICROOSQUEUE_OVERWRITE_SIZE_MAX)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    obj->policy = policy;
+
+    return MICROOS_OK;
+}
+
+#if MICROOS_QUEUE_STATS_ENABLE
+MicroOS_Status_t MicroOSQueue_GetStats(MicroOSQueue_Obj_t *obj, MicroOSQueue_Stats_t *stats)
+{
+    MICROOS_CHECK_PTR(obj);
+    MICROOS_CHECK_PTR(stats);
+
+    stats->Pushes = MICROOS_ATOMIC_LOAD(&obj->stats.Pushes);
+    stats->Pops = MICROOS_ATOMIC_LOAD(&obj->stats.Pops);
+    stats->Drops = MICROOS_ATOMIC_LOAD(&obj->stats.Drops);
+    stats->Overwrites = MICROOS_ATOMIC_LOAD(&obj->stats.Overwrites);
+    stats->HighWater = MICROOS_ATOMIC_LOAD(&obj->stats.HighWater);
+
+    return MICROOS_OK;
+}
+#endif
+
+MicroOS_Status_t MicroOSQueue_ResetStats(MicroOSQueue_Obj_t *obj)
+{
+    MICROOS_CHECK_PTR(obj);
+
+#if MICROOS_QUEUE_STATS_ENABLE
+    memset(&obj->stats, 0, sizeof(obj->stats));
+#endif
 
     return MICROOS_OK;
 }
 
 bool MicroOSQueue_IsEmpty(MicroOSQueue_Obj_t *obj)
 {
-    return (obj->head == obj->tail);
+    return (MicroOSQueue_LoadHead(obj) == MICROOS_ATOMIC_LOAD(&obj->tail));
 }
 
 
 
 bool MicroOSQueue_IsFull(MicroOSQueue_Obj_t *obj)
 {
-    return ((obj->tail - obj->head) >= MICROOS_QUEUE_DEPTH);
+
+    uint32_t skip;
+
+
+    // 以最大长度消息为准: 放不下一条 msg_size 的消息即视为满
+    return !MicroOSQueue_Fits(obj, obj->tail, MicroOSQueue_LoadHead(obj), obj->msg_size, &skip);
 }
 
 
 
-MicroOS_Status_t MicroOSQueue_Push(MicroOSQueue_Obj_t *obj,const void *data,size_t size)
+MicroOS_Status_t MicroOSQueue_Reserve(MicroOSQueue_Obj_t *obj,size_t size,void **data)
 {
 
     MICROOS_CHECK_PTR(obj);
     MICROOS_CHECK_PTR(data);
 
 
-    if(size > MICROOS_QUEUE_SINGLE_MSG_SIZE)
+    uint32_t tail = obj->tail;
+    MicroOS_Status_t ret = MicroOSQueue_Claim(obj,&tail,size);
+
+
+    if(ret == MICROOS_QUEUE_FULL)
     {
-        return MICROOS_ERROR;
+        MICROOSQUEUE_STAT_ADD(obj->stats.Drops, 1U);
+    }
+
+
+    if(ret != MICROOS_OK)
+    {
+        return ret;
     }
 
 
-    if(MicroOSQueue_IsFull(obj))
+    // 跳过了尾部: 回绕标记直接发布, 读端会跳过它
+    if(tail != obj->tail)
     {
-        return MICROOS_QUEUE_FULL;
+        MICROOS_ATOMIC_STORE(&obj->tail, tail);
     }
 
 
-    uint32_t index = obj->tail % MICROOS_QUEUE_DEPTH;
+    // 直接把写位置交给生产者, Commit 之前消费者看不到
+    *data = MICROOSQUEUE_AT(obj, MICROOSQUEUE_OFFSET(obj, tail))->data;
+    obj->reserved = (uint32_t)size;
+    obj->reserving = true;
+
+
+    return MICROOS_OK;
+}
+
+
+
+MicroOS_Status_t MicroOSQueue_Commit(MicroOSQueue_Obj_t *obj,size_t size)
+{
+
+    MICROOS_CHECK_PTR(obj);
+
+
+    // 只能提交 Reserve 检查过空间的那一段, 多写会越过空闲区覆盖未读的消息
+    if(!obj->reserving || size > obj->reserved)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    obj->reserving = false;
 
 
-    obj->buffer[index].len = size;
+    // 只占用 头 + 实际长度, 没有按最大长度的填充
+    MICROOSQUEUE_AT(obj, MICROOSQUEUE_OFFSET(obj, obj->tail))->len = size;
 
 
-    memcpy(obj->buffer[index].data,data,size);
+    // release: 消息内容和长度先于新的 tail 对读端可见
+    MICROOS_ATOMIC_STORE(&obj->tail, MicroOSQueue_Advance(obj, obj->tail, MICROOSQUEUE_SLOT_SIZE(size)));
 
 
-    obj->tail++;
+    MicroOSQueue_Published(obj,1U);
 
 
     return MICROOS_OK;
@@ -71,31 +397,864 @@ MicroOS_Status_t MicroOSQueue_Push(MicroOSQueue_Obj_t *obj,const void *data,size
 
 
 
-MicroOS_Status_t MicroOSQueue_Pop(MicroOSQueue_Obj_t *obj,void *data,size_t *size)
+MicroOS_Status_t MicroOSQueue_Peek(MicroOSQueue_Obj_t *obj,const MicroOSQueue_Message_t **msg)
 {
 
     MICROOS_CHECK_PTR(obj);
-    MICROOS_CHECK_PTR(data);
-    MICROOS_CHECK_PTR(size);
+    MICROOS_CHECK_PTR(msg);
+
+
+    uint32_t head = MicroOSQueue_HoldHead(obj);
+    bool ready = MicroOSQueue_Next(obj,&head);
+
 
+    // 跳过的回绕标记直接还给写端; 有消息时继续持有到 Release
+    MicroOSQueue_PutHead(obj,head,ready);
 
-    if(MicroOSQueue_IsEmpty(obj))
+
+    if(!ready)
     {
         return MICROOS_QUEUE_EMPTY;
     }
 
 
-    uint32_t index = obj->head % MICROOS_QUEUE_DEPTH;
+    // 原地读取, 消息总是连续存放, Release 之前不会被生产者覆盖
+    *msg = MICROOSQUEUE_AT(obj, MICROOSQUEUE_OFFSET(obj, head));
+
+
+    return MICROOS_OK;
+}
+
+
+
+MicroOS_Status_t MicroOSQueue_Release(MicroOSQueue_Obj_t *obj)
+{
+
+    MICROOS_CHECK_PTR(obj);
+
+
+    return (MicroOSQueue_ReleaseN(obj,1U) == 1U) ? MICROOS_OK : MICROOS_QUEUE_EMPTY;
+}
+
+
+
+uint32_t MicroOSQueue_PeekN(MicroOSQueue_Obj_t *obj,const MicroOSQueue_Message_t **msgs,uint32_t count)
+{
+
+    if(obj == NULL || msgs == NULL)
+    {
+        return 0;
+    }
+
+
+    uint32_t head = MicroOSQueue_HoldHead(obj);
+    uint32_t pos = head;
+    uint32_t n = 0;
+
 
+    // 只在本地向前走, 不释放任何消息
+    while(n < count && MicroOSQueue_Next(obj,&pos))
+    {
+        const MicroOSQueue_Message_t *msg = MICROOSQUEUE_AT(obj, MICROOSQUEUE_OFFSET(obj, pos));
 
-    *size = obj->buffer[index].len;
+        msgs[n++] = msg;
+        pos = MicroOSQueue_Advance(obj, pos, MICROOSQUEUE_SLOT_SIZE(msg->len));
+    }
 
 
-    memcpy(data,obj->buffer[index].data,*size);
+    // 有消息时继续持有到 ReleaseN
+    MicroOSQueue_PutHead(obj,head,n != 0);
 
 
-    obj->head++;
+    return n;
+}
 
 
-    return MICROOS_OK;
+
+uint32_t MicroOSQueue_ReleaseN(MicroOSQueue_Obj_t *obj,uint32_t count)
+{
+
+    if(obj == NULL)
+    {
+        return 0;
+    }
+
+
+    uint32_t head = MicroOSQueue_HoldHead(obj);
+    uint32_t n = 0;
+
+
+    while(n < count && MicroOSQueue_Next(obj,&head))
+    {
+        head = MicroOSQueue_Advance(obj, head, MICROOSQUEUE_SLOT_SIZE(MICROOSQUEUE_AT(obj, MICROOSQUEUE_OFFSET(obj, head))->len));
+        n++;
+    }
+
+
+    // 对这批槽位的读取完成之后, 一次性把空间还给写端
+    MicroOSQueue_PutHead(obj,head,false);
+    MICROOSQUEUE_STAT_ADD(obj->stats.Pops, n);
+
+
+    return n;
+}
+
+
+
+MicroOS_Status_t MicroOSQueue_Push(MicroOSQueue_Obj_t *obj,const void *data,size_t size)
+{
+
+    MICROOS_CHECK_PTR(obj);
+    MICROOS_CHECK_PTR(data);
+
+
+    void *slot;
+    MicroOS_Status_t ret = MicroOSQueue_Reserve(obj,size,&slot);
+
+
+    // 丢弃最新: 满时静默丢掉这条消息 (已计入 Drops)
+    if(ret == MICROOS_QUEUE_FULL && obj->policy == MICROOSQUEUE_POLICY_DROP_NEWEST)
+    {
+        return MICROOS_OK;
+    }
+
+
+    if(ret != MICROOS_OK)
+    {
+        return ret;
+    }
+
+
+    memcpy(slot,data,size);
+
+
+    return MicroOSQueue_Commit(obj,size);
+}
+
+
+
+MicroOS_Status_t MicroOSQueue_Pop(MicroOSQueue_Obj_t *obj,void *data,size_t *size)
+{
+
+    MICROOS_CHECK_PTR(data);
+    MICROOS_CHECK_PTR(size);
+
+
+    const MicroOSQueue_Message_t *msg;
+
+
+    MIROOS_CHECK_ERR(MicroOSQueue_Peek(obj,&msg));
+
+
+    *size = msg->len;
+
+
+    memcpy(data,msg->data,*size);
+
+
+    return MicroOSQueue_Release(obj);
+}
+
+
+
+uint32_t MicroOSQueue_PushN(MicroOSQueue_Obj_t *obj,const void *data,size_t size,uint32_t count)
+{
+
+    if(obj == NULL || data == NULL)
+    {
+        return 0;
+    }
+
+
+    uint32_t tail = obj->tail;
+    uint32_t n = 0;
+
+
+    for(; n < count; n++)
+    {
+        if(MicroOSQueue_Claim(obj,&tail,size) != MICROOS_OK)
+        {
+            break;
+        }
+
+        MicroOSQueue_Message_t *msg = MICROOSQUEUE_AT(obj, MICROOSQUEUE_OFFSET(obj, tail));
+
+        msg->len = size;
+        memcpy(msg->data,(const uint8_t *)data + n * size,size);
+
+        tail = MicroOSQueue_Advance(obj, tail, MICROOSQUEUE_SLOT_SIZE(size));
+    }
+
+
+    // release: 整批消息写完后只发布一次 tail
+    if(tail != obj->tail)
+    {
+        MICROOS_ATOMIC_STORE(&obj->tail, tail);
+    }
+
+
+    MicroOSQueue_Published(obj,n);
+    MICROOSQUEUE_STAT_ADD(obj->stats.Drops, count - n);
+
+
+    return n;
+}
+
+
+
+uint32_t MicroOSQueue_PopN(MicroOSQueue_Obj_t *obj,void *data,size_t stride,size_t *lens,uint32_t count)
+{
+
+    if(obj == NULL || data == NULL)
+    {
+        return 0;
+    }
+
+
+    uint32_t head = MicroOSQueue_HoldHead(obj);
+    uint32_t n = 0;
+
+
+    while(n < count && MicroOSQueue_Next(obj,&head))
+    {
+        const MicroOSQueue_Message_t *msg = MICROOSQUEUE_AT(obj, MICROOSQUEUE_OFFSET(obj, head));
+
+        // 放不进一个 stride 的消息留在队列里
+        if(msg->len > stride)
+        {
+            break;
+        }
+
+        memcpy((uint8_t *)data + n * stride,msg->data,msg->len);
+
+        if(lens)
+        {
+            lens[n] = msg->len;
+        }
+
+        head = MicroOSQueue_Advance(obj, head, MICROOSQUEUE_SLOT_SIZE(msg->len));
+        n++;
+    }
+
+
+    // 整批拷贝完成后只归还一次 head
+    MicroOSQueue_PutHead(obj,head,false);
+    MICROOSQUEUE_STAT_ADD(obj->stats.Pops, n);
+
+
+    return n;
+}
+
+
+
+// MPSC 槽位: 开头是序号字, 后面紧跟消息
+#define MICROOSQUEUE_MPSC_SEQ(obj, index) ((volatile uint32_t *)((obj)->buffer + (index) * (obj)->slot_size))
+#define MICROOSQUEUE_MPSC_MSG(obj, index) ((MicroOSQueue_Message_t *)((obj)->buffer + (index) * (obj)->slot_size + sizeof(size_t)))
+
+MicroOS_Status_t MicroOSQueue_MPSC_Init(MicroOSQueue_MPSC_t *obj, void *buffer, uint32_t depth, uint32_t msg_size)
+{
+    MICROOS_CHECK_PTR(obj);
+    MICROOS_CHECK_PTR(buffer);
+
+    if (depth < 2U || (depth & (depth - 1U)) != 0U || msg_size == 0)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    obj->buffer = (uint8_t *)buffer;
+    obj->mask = depth - 1U;
+    obj->msg_size = msg_size;
+    obj->slot_size = MICROOSQUEUE_MPSC_SLOT_SIZE(msg_size);
+    obj->policy = MICROOSQUEUE_POLICY_REJECT;
+
+    MicroOSQueue_MPSC_ResetStats(obj);
+
+    return MicroOSQueue_MPSC_Reset(obj);
+}
+
+MicroOS_Status_t MicroOSQueue_MPSC_SetPolicy(MicroOSQueue_MPSC_t *obj, uint8_t policy)
+{
+    MICROOS_CHECK_PTR(obj);
+
+    // 多个写端无法安全地回收读端的槽位, 不支持覆盖最旧
+    if (policy > MICROOSQUEUE_POLICY_DROP_NEWEST)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    obj->policy = policy;
+
+    return MICROOS_OK;
+}
+
+#if MICROOS_QUEUE_STATS_ENABLE
+MicroOS_Status_t MicroOSQueue_MPSC_GetStats(MicroOSQueue_MPSC_t *obj, MicroOSQueue_Stats_t *stats)
+{
+    MICROOS_CHECK_PTR(obj);
+    MICROOS_CHECK_PTR(stats);
+
+    stats->Pushes = MICROOS_ATOMIC_LOAD(&obj->stats.Pushes);
+    stats->Pops = MICROOS_ATOMIC_LOAD(&obj->stats.Pops);
+    stats->Drops = MICROOS_ATOMIC_LOAD(&obj->stats.Drops);
+    stats->Overwrites = 0;
+    stats->HighWater = MICROOS_ATOMIC_LOAD(&obj->stats.HighWater);
+
+    return MICROOS_OK;
+}
+#endif
+
+MicroOS_Status_t MicroOSQueue_MPSC_ResetStats(MicroOSQueue_MPSC_t *obj)
+{
+    MICROOS_CHECK_PTR(obj);
+
+#if MICROOS_QUEUE_STATS_ENABLE
+    memset(&obj->stats, 0, sizeof(obj->stats));
+#endif
+
+    return MICROOS_OK;
+}
+
+MicroOS_Status_t MicroOSQueue_MPSC_Reset(MicroOSQueue_MPSC_t *obj)
+{
+    MICROOS_CHECK_PTR(obj);
+
+    // 序号字全部清零即为空队列
+    memset(obj->buffer, 0, (obj->mask + 1U) * obj->slot_size);
+
+    obj->head = 0;
+    obj->tail = 0;
+
+    return MICROOS_OK;
+}
+
+bool MicroOSQueue_MPSC_IsEmpty(MicroOSQueue_MPSC_t *obj)
+{
+    uint32_t head = obj->head;
+
+    return (MICROOS_ATOMIC_LOAD(MICROOSQUEUE_MPSC_SEQ(obj, head & obj->mask)) != (head & ~obj->mask) + 1U);
+}
+
+
+
+MicroOS_Status_t MicroOSQueue_MPSC_Push(MicroOSQueue_MPSC_t *obj,const void *data,size_t size)
+{
+
+    MICROOS_CHECK_PTR(obj);
+    MICROOS_CHECK_PTR(data);
+
+
+    if(size > obj->msg_size)
+    {
+        return MICROOS_ERROR;
+    }
+
+
+    uint32_t pos = MICROOS_ATOMIC_LOAD(&obj->tail);
+    volatile uint32_t *seq;
+
+
+    for (;;)
+    {
+        seq = MICROOSQUEUE_MPSC_SEQ(obj, pos & obj->mask);
+
+        int32_t diff = (int32_t)(MICROOS_ATOMIC_LOAD(seq) - (pos & ~obj->mask));
+
+        if (diff == 0)
+        {
+            // 槽位空闲, 抢占 pos; 失败时 pos 被刷新为最新的 tail, 重试
+            if (MICROOS_ATOMIC_CAS(&obj->tail, &pos, pos + 1U))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // 槽位还是上一圈的消息, 读端没来得及取走
+#if MICROOS_QUEUE_STATS_ENABLE
+            MICROOS_ATOMIC_FETCH_ADD(&obj->stats.Drops, 1U);
+#endif
+            return (obj->policy == MICROOSQUEUE_POLICY_DROP_NEWEST) ? MICROOS_OK : MICROOS_QUEUE_FULL;
+        }
+        else
+        {
+            // 其他生产者已经抢走了 pos
+            pos = MICROOS_ATOMIC_LOAD(&obj->tail);
+        }
+    }
+
+
+    MicroOSQueue_Message_t *msg = MICROOSQUEUE_MPSC_MSG(obj, pos & obj->mask);
+
+    msg->len = size;
+    memcpy(msg->data,data,size);
+
+
+    // release: 消息写完后才对读端标记为已填充
+    MICROOS_ATOMIC_STORE(seq, (pos & ~obj->mask) + 1U);
+
+
+#if MICROOS_QUEUE_STATS_ENABLE
+    MICROOS_ATOMIC_FETCH_ADD(&obj->stats.Pushes, 1U);
+
+    // 多个写端并发更新峰值, 用 CAS 取最大
+    uint32_t held = pos + 1U - MICROOS_ATOMIC_LOAD(&obj->head);
+    uint32_t peak = MICROOS_ATOMIC_LOAD(&obj->stats.HighWater);
+
+    while (held > peak && !MICROOS_ATOMIC_CAS(&obj->stats.HighWater, &peak, held))
+    {
+    }
+#endif
+
+
+    return MICROOS_OK;
+}
+
+
+
+MicroOS_Status_t MicroOSQueue_MPSC_Peek(MicroOSQueue_MPSC_t *obj,const MicroOSQueue_Message_t **msg)
+{
+
+    MICROOS_CHECK_PTR(obj);
+    MICROOS_CHECK_PTR(msg);
+
+
+    // 按序号判断: 即使后面的槽位已填充, head 所在槽位没发布前也不会越过它
+    if(MicroOSQueue_MPSC_IsEmpty(obj))
+    {
+        return MICROOS_QUEUE_EMPTY;
+    }
+
+
+    *msg = MICROOSQUEUE_MPSC_MSG(obj, obj->head & obj->mask);
+
+
+    return MICROOS_OK;
+}
+
+
+
+uint32_t MicroOSQueue_MPSC_PeekN(MicroOSQueue_MPSC_t *obj,const MicroOSQueue_Message_t **msgs,uint32_t count)
+{
+
+    if(obj == NULL || msgs == NULL)
+    {
+        return 0;
+    }
+
+
+    uint32_t n = 0;
+
+
+    // 从 head 开始连续已发布的槽位, 遇到未发布的槽位就停下, 保证顺序
+    for(; n < count; n++)
+    {
+        uint32_t pos = obj->head + n;
+
+        if(MICROOS_ATOMIC_LOAD(MICROOSQUEUE_MPSC_SEQ(obj, pos & obj->mask)) != (pos & ~obj->mask) + 1U)
+        {
+            break;
+        }
+
+        msgs[n] = MICROOSQUEUE_MPSC_MSG(obj, pos & obj->mask);
+    }
+
+
+    return n;
+}
+
+
+
+uint32_t MicroOSQueue_MPSC_ReleaseN(MicroOSQueue_MPSC_t *obj,uint32_t count)
+{
+
+    if(obj == NULL)
+    {
+        return 0;
+    }
+
+
+    uint32_t n = 0;
+
+
+    while(n < count && MicroOSQueue_MPSC_Release(obj) == MICROOS_OK)
+    {
+        n++;
+    }
+
+
+    return n;
+}
+
+
+
+MicroOS_Status_t MicroOSQueue_MPSC_Release(MicroOSQueue_MPSC_t *obj)
+{
+
+    MICROOS_CHECK_PTR(obj);
+
+
+    if(MicroOSQueue_MPSC_IsEmpty(obj))
+    {
+        return MICROOS_QUEUE_EMPTY;
+    }
+
+
+    uint32_t head = obj->head;
+
+
+    // 槽位交还给下一圈的生产者
+    MICROOS_ATOMIC_STORE(MICROOSQUEUE_MPSC_SEQ(obj, head & obj->mask), (head & ~obj->mask) + obj->mask + 1U);
+
+
+    MICROOS_ATOMIC_STORE(&obj->head, head + 1U);
+    MICROOSQUEUE_STAT_ADD(obj->stats.Pops, 1U);
+
+
+    return MICROOS_OK;
+}
+
+
+
+// 字节流的读写位置同样在 [0, 2 * size) 内计数, 取偏移复用 MICROOSQUEUE_OFFSET
+static inline uint32_t MicroOSQueue_Stream_Advance(const MicroOSQueue_Stream_t *obj, uint32_t pos, uint32_t n)
+{
+    pos += n;
+
+    if (obj->mask)
+    {
+        return pos & (2U * obj->size - 1U);
+    }
+
+    return (pos >= 2U * obj->size) ? pos - 2U * obj->size : pos;
+}
+
+static inline uint32_t MicroOSQueue_Stream_Count(const MicroOSQueue_Stream_t *obj, uint32_t tail, uint32_t head)
+{
+    return (tail >= head) ? tail - head : tail + 2U * obj->size - head;
+}
+
+MicroOS_Status_t MicroOSQueue_Stream_Init(MicroOSQueue_Stream_t *obj, void *buffer, uint32_t size)
+{
+    MICROOS_CHECK_PTR(obj);
+    MICROOS_CHECK_PTR(buffer);
+
+    if (size == 0)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    obj->buffer = (uint8_t *)buffer;
+    obj->size = size;
+    obj->mask = MICROOSQUEUE_MASK(size);
+
+    return MicroOSQueue_Stream_Reset(obj);
+}
+
+MicroOS_Status_t MicroOSQueue_Stream_Reset(MicroOSQueue_Stream_t *obj)
+{
+    MICROOS_CHECK_PTR(obj);
+
+    obj->head = 0;
+    obj->tail = 0;
+
+    return MICROOS_OK;
+}
+
+size_t MicroOSQueue_Stream_Used(MicroOSQueue_Stream_t *obj)
+{
+    if (obj == NULL)
+    {
+        return 0;
+    }
+
+    return MicroOSQueue_Stream_Count(obj, MICROOS_ATOMIC_LOAD(&obj->tail), MICROOS_ATOMIC_LOAD(&obj->head));
+}
+
+
+
+size_t MicroOSQueue_Stream_WriteRegion(MicroOSQueue_Stream_t *obj, uint8_t **region)
+{
+
+    if(obj == NULL || region == NULL)
+    {
+        return 0;
+    }
+
+
+    uint32_t tail = obj->tail;
+    uint32_t offset = MICROOSQUEUE_OFFSET(obj, tail);
+
+    // acquire: 读端对这段空间的读取已经完成
+    uint32_t space = obj->size - MicroOSQueue_Stream_Count(obj, tail, MICROOS_ATOMIC_LOAD(&obj->head));
+
+
+    // 连续区域到缓冲区末尾为止, 回绕后的部分下次再取
+    *region = obj->buffer + offset;
+
+
+    return (space < obj->size - offset) ? space : obj->size - offset;
+}
+
+
+
+MicroOS_Status_t MicroOSQueue_Stream_CommitWrite(MicroOSQueue_Stream_t *obj, size_t len)
+{
+
+    MICROOS_CHECK_PTR(obj);
+
+
+    uint8_t *region;
+
+
+    if(len > MicroOSQueue_Stream_WriteRegion(obj, &region))
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+
+    // release: DMA/驱动写入的数据先于新的 tail 对读端可见
+    MICROOS_ATOMIC_STORE(&obj->tail, MicroOSQueue_Stream_Advance(obj, obj->tail, (uint32_t)len));
+
+
+    return MICROOS_OK;
+}
+
+
+
+size_t MicroOSQueue_Stream_ReadRegion(MicroOSQueue_Stream_t *obj, const uint8_t **region)
+{
+
+    if(obj == NULL || region == NULL)
+    {
+        return 0;
+    }
+
+
+    uint32_t head = obj->head;
+    uint32_t offset = MICROOSQUEUE_OFFSET(obj, head);
+
+    // acquire: 写端发布的数据已经可见
+    uint32_t used = MicroOSQueue_Stream_Count(obj, MICROOS_ATOMIC_LOAD(&obj->tail), head);
+
+
+    *region = obj->buffer + offset;
+
+
+    return (used < obj->size - offset) ? used : obj->size - offset;
+}
+
+
+
+MicroOS_Status_t MicroOSQueue_Stream_ReleaseRead(MicroOSQueue_Stream_t *obj, size_t len)
+{
+
+    MICROOS_CHECK_PTR(obj);
+
+
+    const uint8_t *region;
+
+
+    if(len > MicroOSQueue_Stream_ReadRegion(obj, &region))
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+
+    // release: 读取完成之后才把空间还给写端
+    MICROOS_ATOMIC_STORE(&obj->head, MicroOSQueue_Stream_Advance(obj, obj->head, (uint32_t)len));
+
+
+    return MICROOS_OK;
+}
+
+
+
+// 读端: 找出最紧急的非空级别. 写端 "先写消息后置位", 读端 "先清位再复查", 清位期间写入的消息不会被漏掉
+static bool MicroOSQueue_Prio_Select(MicroOSQueue_Prio_t *obj, uint8_t *level)
+{
+    // 上次取出的消息还没释放, 继续留在这一级
+    if (obj->held)
+    {
+        *level = obj->current;
+        return true;
+    }
+
+    uint32_t ready = MICROOS_ATOMIC_LOAD(&obj->ready);
+
+    while (ready)
+    {
+        uint8_t lvl = MICROOS_CLZ(ready);
+
+        if (MicroOSQueue_IsEmpty(obj->levels[lvl]))
+        {
+            MICROOS_ATOMIC_FETCH_AND(&obj->ready, ~MICROOS_BIT(lvl));
+
+            if (MicroOSQueue_IsEmpty(obj->levels[lvl]))
+            {
+                ready = MICROOS_ATOMIC_LOAD(&obj->ready);
+                continue;
+            }
+
+            MICROOS_ATOMIC_FETCH_OR(&obj->ready, MICROOS_BIT(lvl));
+        }
+
+        *level = lvl;
+        return true;
+    }
+
+    return false;
+}
+
+MicroOS_Status_t MicroOSQueue_Prio_Init(MicroOSQueue_Prio_t *obj, MicroOSQueue_Obj_t *const *levels, uint8_t count)
+{
+    MICROOS_CHECK_PTR(obj);
+    MICROOS_CHECK_PTR(levels);
+
+    if (count == 0 || count > MICROOSQUEUE_PRIO_LEVELS_MAX)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        MICROOS_CHECK_PTR(levels[i]);
+    }
+
+    obj->levels = levels;
+    obj->count = count;
+
+    return MicroOSQueue_Prio_Reset(obj);
+}
+
+MicroOS_Status_t MicroOSQueue_Prio_Reset(MicroOSQueue_Prio_t *obj)
+{
+    MICROOS_CHECK_PTR(obj);
+
+    for (uint8_t i = 0; i < obj->count; i++)
+    {
+        MicroOSQueue_Reset(obj->levels[i]);
+    }
+
+    obj->ready = 0;
+    obj->current = 0;
+    obj->held = 0;
+
+    return MICROOS_OK;
+}
+
+bool MicroOSQueue_Prio_IsEmpty(MicroOSQueue_Prio_t *obj)
+{
+    for (uint8_t i = 0; i < obj->count; i++)
+    {
+        if (!MicroOSQueue_IsEmpty(obj->levels[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+MicroOS_Status_t MicroOSQueue_Prio_Push(MicroOSQueue_Prio_t *obj,uint8_t prio,const void *data,size_t size)
+{
+
+    MICROOS_CHECK_PTR(obj);
+
+
+    if (prio >= obj->count)
+    {
+        return MICROOS_INVALID_PARAM;
+    }
+
+
+    MicroOS_Status_t ret = MicroOSQueue_Push(obj->levels[prio],data,size);
+
+
+    // 消息发布之后再置位, 读端看到置位时消息一定可见
+    if (ret == MICROOS_OK)
+    {
+        MICROOS_ATOMIC_FETCH_OR(&obj->ready, MICROOS_BIT(prio));
+    }
+
+
+    return ret;
+}
+
+MicroOS_Status_t MicroOSQueue_Prio_Peek(MicroOSQueue_Prio_t *obj,const MicroOSQueue_Message_t **msg)
+{
+
+    MICROOS_CHECK_PTR(obj);
+    MICROOS_CHECK_PTR(msg);
+
+
+    uint8_t level;
+
+
+    if (!MicroOSQueue_Prio_Select(obj,&level))
+    {
+        return MICROOS_QUEUE_EMPTY;
+    }
+
+
+    MicroOS_Status_t ret = MicroOSQueue_Peek(obj->levels[level],msg);
+
+
+    obj->current = level;
+    obj->held = (ret == MICROOS_OK);
+
+
+    return ret;
+}
+
+uint32_t MicroOSQueue_Prio_PeekN(MicroOSQueue_Prio_t *obj,const MicroOSQueue_Message_t **msgs,uint32_t count)
+{
+
+    if (obj == NULL || msgs == NULL)
+    {
+        return 0;
+    }
+
+
+    uint8_t level;
+
+
+    if (!MicroOSQueue_Prio_Select(obj,&level))
+    {
+        return 0;
+    }
+
+
+    // 一批只来自同一级, 更紧急的消息在下一批优先
+    uint32_t n = MicroOSQueue_PeekN(obj->levels[level],msgs,count);
+
+
+    obj->current = level;
+    obj->held = (n != 0);
+
+
+    return n;
+}
+
+uint32_t MicroOSQueue_Prio_ReleaseN(MicroOSQueue_Prio_t *obj,uint32_t count)
+{
+
+    if (obj == NULL || !obj->held)
+    {
+        return 0;
+    }
+
+
+    obj->held = 0;
+
+
+    return MicroOSQueue_ReleaseN(obj->levels[obj->current],count);
+}
+
+MicroOS_Status_t MicroOSQueue_Prio_Release(MicroOSQueue_Prio_t *obj)
+{
+
+    MICROOS_CHECK_PTR(obj);
+
+
+    return (MicroOSQueue_Prio_ReleaseN(obj,1U) == 1U) ? MICROOS_OK : MICROOS_QUEUE_EMPTY;
 }